@@ -0,0 +1,81 @@
+#include "acpi"
+
+/* Kernel */
+#include "page_manager"
+
+/* The RSDP, ACPI 1.0 fields only */
+struct rsdp_t
+{
+  char signature[8];
+  uint8_t checksum;
+  char oem_id[6];
+  uint8_t revision;
+  uint32_t rsdt_address;
+} __attribute__((packed));
+
+/* The physical address of the RSDT (0 if unknown) */
+static uint32_t rsdt_address;
+
+/* ACPI structures sum to 0 */
+static bool checksum_ok(const void* p, uint32_t length)
+{
+  const uint8_t* bytes = static_cast<const uint8_t*>(p);
+  uint8_t sum = 0;
+  for(uint32_t i = 0; i < length; ++i)
+    sum += bytes[i];
+  return sum == 0;
+}
+
+/* Maps a table's header, which may cross a 4MiB page */
+static const acpi::sdt_header* map_header(uint32_t phys)
+{
+  page_manager* pager = page_manager::get_current_manager();
+
+  pager->map_identity(phys + sizeof(acpi::sdt_header) - 1);
+  return static_cast<const acpi::sdt_header*>(pager->map_identity(phys));
+}
+
+/* Maps the rest of a table, and validates it */
+static bool map_body(const acpi::sdt_header* header)
+{
+  uintptr_t phys = reinterpret_cast<uintptr_t>(header);
+  page_manager::get_current_manager()->map_identity(phys + header->length - 1);
+
+  return checksum_ok(header, header->length);
+}
+
+/* RSDP */
+void acpi::set_rsdp(const void* rsdp)
+{
+  if(!checksum_ok(rsdp, sizeof(rsdp_t)))
+    return;
+
+  rsdt_address = static_cast<const rsdp_t*>(rsdp)->rsdt_address;
+}
+
+/* Table lookup */
+const acpi::sdt_header* acpi::find_table(const char* signature)
+{
+  if(!rsdt_address)
+    return nullptr;
+
+  const sdt_header* rsdt = map_header(rsdt_address);
+  if(!map_body(rsdt))
+    return nullptr;
+
+  /* The RSDT is followed by 32-bit physical table pointers */
+  const uint32_t* tables = reinterpret_cast<const uint32_t*>(rsdt + 1);
+  uint32_t count = (rsdt->length - sizeof(sdt_header)) / sizeof(uint32_t);
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    const sdt_header* table = map_header(tables[i]);
+    if(table->signature[0] == signature[0] &&
+       table->signature[1] == signature[1] &&
+       table->signature[2] == signature[2] &&
+       table->signature[3] == signature[3])
+      return map_body(table) ? table : nullptr;
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * Minimal ACPI table discovery (RSDP -> RSDT -> tables)
+ */
+namespace acpi
+{
+  /**
+   * @struct sdt_header
+   * @brief The header common to every ACPI table
+   */
+  struct sdt_header
+  {
+    char signature[4];
+    uint32_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+  } __attribute__((packed));
+
+  /**
+   * @struct madt
+   * @brief The Multiple APIC Description Table ("APIC")
+   */
+  struct madt : public sdt_header
+  {
+    /* Entry types */
+    enum entry_type : uint8_t
+    {
+      LOCAL_APIC = 0,
+      IO_APIC = 1,
+      SOURCE_OVERRIDE = 2,
+      LOCAL_APIC_NMI = 4,
+      LOCAL_APIC_OVERRIDE = 5,
+    };
+
+    /* The header of every entry */
+    struct entry
+    {
+      entry_type type;
+      uint8_t length;
+
+      const entry* next() const
+      { return reinterpret_cast<const entry*>(reinterpret_cast<const uint8_t*>(this) + length); }
+    } __attribute__((packed));
+
+    struct local_apic : public entry
+    {
+      uint8_t processor_id;
+      uint8_t apic_id;
+      uint32_t flags;     /* Bit 0 = enabled */
+    } __attribute__((packed));
+
+    struct io_apic : public entry
+    {
+      uint8_t id;
+      uint8_t reserved;
+      uint32_t address;
+      uint32_t gsi_base;
+    } __attribute__((packed));
+
+    /* Maps an ISA IRQ to a different global system interrupt */
+    struct source_override : public entry
+    {
+      uint8_t bus;
+      uint8_t source;
+      uint32_t gsi;
+      uint16_t flags;     /* Polarity in bits 0-1, trigger mode in bits 2-3 */
+    } __attribute__((packed));
+
+    struct local_apic_override : public entry
+    {
+      uint16_t reserved;
+      uint64_t address;
+    } __attribute__((packed));
+
+    uint32_t local_apic_address;
+    uint32_t flags;       /* Bit 0 = legacy 8259s are present */
+
+    const entry* first() const
+    { return reinterpret_cast<const entry*>(this + 1); }
+
+    const entry* end() const
+    { return reinterpret_cast<const entry*>(reinterpret_cast<const uint8_t*>(this) + length); }
+  } __attribute__((packed));
+
+  /**
+   * Records the RSDP (from the multiboot2 ACPI tags)
+   * Only stores the RSDT address, so it's safe before global constructors
+   *
+   * @param rsdp    The RSDP structure, ignored if its checksum is bad
+   */
+  void set_rsdp(const void* rsdp);
+
+  /**
+   * Finds (and maps) an ACPI table
+   * Requires paging
+   *
+   * @param signature   The 4-character table signature (i.e. "APIC")
+   * @return The table, or nullptr if it's missing or corrupt
+   */
+  const sdt_header* find_table(const char* signature);
+}
@@ -0,0 +1,268 @@
+#include "apic"
+
+/* Kernel */
+#include "acpi"
+#include "interrupts"
+#include "page_manager"
+
+/* APEX */
+#include <clock>
+
+/* Local APIC registers (byte offsets) */
+#define LAPIC_ID          0x020
+#define LAPIC_TPR         0x080
+#define LAPIC_SVR         0x0f0
+#define LAPIC_LVT_TIMER   0x320
+#define LAPIC_TIMER_INIT  0x380
+#define LAPIC_TIMER_CUR   0x390
+#define LAPIC_TIMER_DIV   0x3e0
+
+/* LVT and SVR bits */
+#define LVT_MASKED        0x10000
+#define LVT_PERIODIC      0x20000
+#define SVR_ENABLE        0x100
+
+/* The local APIC timer runs at bus clock / 16 */
+#define TIMER_DIV_16      0x3
+
+/* The IA32_APIC_BASE MSR */
+#define MSR_APIC_BASE     0x1b
+#define APIC_BASE_ENABLE  0x800
+
+/* I/O APIC registers */
+#define IOAPIC_VER        0x01
+#define IOAPIC_REDIR      0x10
+
+/* Redirection entry bits */
+#define REDIR_LOW_ACTIVE  0x2000
+#define REDIR_LEVEL       0x8000
+#define REDIR_MASKED      0x10000
+
+/* MPS INTI flags (in source overrides) */
+#define INTI_POLARITY     0x3
+#define INTI_ACTIVE_LOW   0x3
+#define INTI_TRIGGER      0xc
+#define INTI_LEVEL        0xc
+
+/* The most I/O APICs supported */
+#define MAX_IOAPICS       4
+
+/* A single I/O APIC */
+struct ioapic_t
+{
+  volatile uint32_t* regs;
+  uint32_t gsi_base;
+  uint32_t gsi_count;
+
+  uint32_t read(uint8_t reg)
+  {
+    regs[0] = reg;
+    return regs[4];
+  }
+
+  void write(uint8_t reg, uint32_t value)
+  {
+    regs[0] = reg;
+    regs[4] = value;
+  }
+};
+
+/* An ISA IRQ's global system interrupt and INTI flags */
+struct isa_route_t
+{
+  uint32_t gsi;
+  uint16_t flags;
+};
+
+volatile uint32_t* apic::detail::lapic;
+
+static ioapic_t ioapics[MAX_IOAPICS];
+static uint8_t ioapic_count;
+
+/* ISA IRQs are identity-mapped to GSIs unless overridden */
+static isa_route_t isa_routes[16];
+
+/* Local APIC register access */
+static uint32_t lapic_read(uint32_t reg)
+{ return apic::detail::lapic[reg / 4]; }
+
+static void lapic_write(uint32_t reg, uint32_t value)
+{ apic::detail::lapic[reg / 4] = value; }
+
+/* MSR access */
+static uint64_t rdmsr(uint32_t msr)
+{
+  uint32_t lo, hi;
+  asm volatile("rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr));
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
+static void wrmsr(uint32_t msr, uint64_t value)
+{
+  asm volatile("wrmsr" : : "c"(msr), "a"(static_cast<uint32_t>(value)), "d"(static_cast<uint32_t>(value >> 32)));
+}
+
+/* The I/O APIC handling a GSI (nullptr if none) */
+static ioapic_t* ioapic_for(uint32_t gsi)
+{
+  for(uint8_t i = 0; i < ioapic_count; ++i)
+    if(gsi >= ioapics[i].gsi_base && gsi < ioapics[i].gsi_base + ioapics[i].gsi_count)
+      return &ioapics[i];
+
+  return nullptr;
+}
+
+/* Spurious interrupts need no EOI */
+static void spurious_handler(interrupts::interrupt_frame&)
+{ }
+
+/* Discovery and setup */
+bool apic::initialize()
+{
+  const acpi::madt* madt = static_cast<const acpi::madt*>(acpi::find_table("APIC"));
+  if(!madt)
+    return false;
+
+  page_manager* pager = page_manager::get_current_manager();
+  uint32_t lapic_address = madt->local_apic_address;
+
+  for(uint8_t i = 0; i < 16; ++i)
+    isa_routes[i] = {i, 0};
+
+  for(const acpi::madt::entry* e = madt->first(); e < madt->end(); e = e->next())
+  {
+    /* Malformed table */
+    if(e->length == 0)
+      break;
+
+    switch(e->type)
+    {
+    case acpi::madt::IO_APIC:
+      if(ioapic_count < MAX_IOAPICS)
+      {
+        const acpi::madt::io_apic* io = static_cast<const acpi::madt::io_apic*>(e);
+        ioapic_t& ioapic = ioapics[ioapic_count++];
+        ioapic.regs = static_cast<volatile uint32_t*>(pager->map_identity(io->address, true));
+        ioapic.gsi_base = io->gsi_base;
+        ioapic.gsi_count = ((ioapic.read(IOAPIC_VER) >> 16) & 0xff) + 1;
+      }
+      break;
+
+    case acpi::madt::SOURCE_OVERRIDE:
+      {
+        const acpi::madt::source_override* iso = static_cast<const acpi::madt::source_override*>(e);
+        if(iso->source < 16)
+          isa_routes[iso->source] = {iso->gsi, iso->flags};
+      }
+      break;
+
+    case acpi::madt::LOCAL_APIC_OVERRIDE:
+      {
+        const acpi::madt::local_apic_override* lo = static_cast<const acpi::madt::local_apic_override*>(e);
+        if(lo->address < 0x100000000ull)
+          lapic_address = static_cast<uint32_t>(lo->address);
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  if(!ioapic_count)
+    return false;
+
+  /* Mask every I/O APIC input until it's routed */
+  for(uint8_t i = 0; i < ioapic_count; ++i)
+    for(uint32_t pin = 0; pin < ioapics[i].gsi_count; ++pin)
+      ioapics[i].write(IOAPIC_REDIR + pin * 2, REDIR_MASKED);
+
+  /* Enable the local APIC */
+  detail::lapic = static_cast<volatile uint32_t*>(pager->map_identity(lapic_address, true));
+  wrmsr(MSR_APIC_BASE, rdmsr(MSR_APIC_BASE) | APIC_BASE_ENABLE);
+
+  interrupts::add(spurious_vector, &spurious_handler, true);
+  lapic_write(LAPIC_TPR, 0);
+  lapic_write(LAPIC_SVR, SVR_ENABLE | spurious_vector);
+
+  return true;
+}
+
+/* Status */
+bool apic::is_enabled()
+{ return detail::lapic != nullptr; }
+
+/* Local APIC id */
+uint8_t apic::id()
+{ return lapic_read(LAPIC_ID) >> 24; }
+
+/* ISA routing */
+void apic::route_isa(uint8_t isa_irq, uint8_t vector, bool masked)
+{
+  isa_route_t const& route = isa_routes[isa_irq];
+  ioapic_t* ioapic = ioapic_for(route.gsi);
+  if(!ioapic)
+    return;
+
+  /* Fixed delivery, physical destination */
+  uint32_t low = vector;
+  if((route.flags & INTI_POLARITY) == INTI_ACTIVE_LOW)
+    low |= REDIR_LOW_ACTIVE;
+  if((route.flags & INTI_TRIGGER) == INTI_LEVEL)
+    low |= REDIR_LEVEL;
+  if(masked)
+    low |= REDIR_MASKED;
+
+  uint8_t reg = IOAPIC_REDIR + (route.gsi - ioapic->gsi_base) * 2;
+  ioapic->write(reg + 1, static_cast<uint32_t>(id()) << 24);
+  ioapic->write(reg, low);
+}
+
+/* ISA masking */
+void apic::mask_isa(uint8_t isa_irq)
+{
+  uint32_t gsi = isa_routes[isa_irq].gsi;
+  ioapic_t* ioapic = ioapic_for(gsi);
+  if(!ioapic)
+    return;
+
+  uint8_t reg = IOAPIC_REDIR + (gsi - ioapic->gsi_base) * 2;
+  ioapic->write(reg, ioapic->read(reg) | REDIR_MASKED);
+}
+
+void apic::unmask_isa(uint8_t isa_irq)
+{
+  uint32_t gsi = isa_routes[isa_irq].gsi;
+  ioapic_t* ioapic = ioapic_for(gsi);
+  if(!ioapic)
+    return;
+
+  uint8_t reg = IOAPIC_REDIR + (gsi - ioapic->gsi_base) * 2;
+  ioapic->write(reg, ioapic->read(reg) & ~REDIR_MASKED);
+}
+
+/* Local APIC timer */
+void apic::start_timer(uint32_t hz, uint8_t vector)
+{
+  /* Count down (masked) for 10ms to find the timer's rate */
+  lapic_write(LAPIC_TIMER_DIV, TIMER_DIV_16);
+  lapic_write(LAPIC_LVT_TIMER, LVT_MASKED | vector);
+  lapic_write(LAPIC_TIMER_INIT, 0xffffffff);
+
+  uint64_t end = apex::clock::now() + 10000000;
+  while(apex::clock::now() < end)
+    ;
+
+  uint32_t per_10ms = 0xffffffff - lapic_read(LAPIC_TIMER_CUR);
+  lapic_write(LAPIC_TIMER_INIT, 0);
+
+  /* Periodic at hz */
+  lapic_write(LAPIC_LVT_TIMER, LVT_PERIODIC | vector);
+  lapic_write(LAPIC_TIMER_INIT, per_10ms * 100 / hz);
+}
+
+void apic::stop_timer()
+{
+  lapic_write(LAPIC_LVT_TIMER, LVT_MASKED);
+  lapic_write(LAPIC_TIMER_INIT, 0);
+}
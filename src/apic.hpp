@@ -0,0 +1,92 @@
+#pragma once
+
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * Driver for the Local APIC and I/O APIC(s)
+ *
+ * Only the boot processor's local APIC is used for now.
+ * Prefer the irq namespace, which falls back to the 8259 PIC.
+ */
+namespace apic
+{
+  /* The vector for spurious local APIC interrupts */
+  constexpr uint8_t spurious_vector = 0xff;
+
+  /**
+   * Parses the MADT, maps the APICs, enables the local APIC,
+   *   and masks every I/O APIC input
+   * Requires paging, acpi::set_rsdp(), and interrupts::setup()
+   *
+   * @return False if there is no usable APIC (nothing is changed)
+   */
+  bool initialize();
+
+  /**
+   * @return True if initialize() succeeded
+   */
+  bool is_enabled();
+
+  /**
+   * @return The current processor's local APIC id
+   */
+  uint8_t id();
+
+  /**
+   * Implementation details
+   */
+  namespace detail
+  {
+    /* The local APIC's registers (nullptr until initialized) */
+    extern volatile uint32_t* lapic;
+  }
+
+  /**
+   * Signals the end of an interrupt to the local APIC
+   * (a single MMIO write)
+   */
+  inline void eoi()
+  { detail::lapic[0xb0 / 4] = 0; }
+
+  /**
+   * Routes an ISA IRQ to a vector on this processor,
+   *   following any MADT source overrides
+   *
+   * @param isa_irq   The legacy IRQ (0-15)
+   * @param vector    The vector to deliver
+   * @param masked    True to leave the input masked
+   */
+  void route_isa(uint8_t isa_irq, uint8_t vector, bool masked = false);
+
+  /**
+   * Masks/unmasks the I/O APIC input for an ISA IRQ
+   */
+  void mask_isa(uint8_t isa_irq);
+  void unmask_isa(uint8_t isa_irq);
+
+  /**
+   * Starts the local APIC timer in periodic mode
+   * Calibrated against apex::clock, which must already be calibrated
+   *
+   * @param hz        The interrupt rate
+   * @param vector    The vector to deliver
+   */
+  void start_timer(uint32_t hz, uint8_t vector);
+
+  /**
+   * Stops the local APIC timer
+   */
+  void stop_timer();
+
+  /**
+   * The address and data for a fixed, edge-triggered MSI to a local APIC
+   *
+   * @param apic_id   The destination processor
+   * @param vector    The vector to deliver
+   */
+  constexpr uint32_t msi_address(uint8_t apic_id)
+  { return 0xfee00000 | (static_cast<uint32_t>(apic_id) << 12); }
+  constexpr uint32_t msi_data(uint8_t vector)
+  { return vector; }
+}
@@ -49,6 +49,17 @@ header:
   dd MB_SIZE
   dd MB_CHKSUM
 
+; Framebuffer tag -- asks for a 32bpp linear framebuffer, the console falls back to text mode without one
+.framebuffer:
+  dw 5                              ; Type
+  dw 1                              ; Flags (optional)
+  dd (.framebuffer_end - .framebuffer)
+  dd 1024                           ; Width
+  dd 768                            ; Height
+  dd 32                             ; Depth
+.framebuffer_end:
+  align 8, db 0
+
 ; Null tag
   dd 0
   dd 0
@@ -111,6 +122,7 @@ global _boot
 _boot:
   cli                   ; No interrupts yet -- no IDT
   mov esp, stack_top    ; Setup the stack
+  xor ebp, ebp          ; Null frame pointer ends stack walks
   call loadGDT          ; Setup the flat GDT and registers
   push ebx              ; Push the pointer to multiboot2 info
   push __page_directory
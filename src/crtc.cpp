@@ -0,0 +1,64 @@
+/* Kernel */
+#include "ports"
+
+/* IO */
+#include <crtc>
+
+#define CRTC_INDEX          0x3d4
+#define CRTC_DATA           0x3d5
+
+#define CRTC_CURSOR_START   0x0a  /* Bit 5 disables the cursor */
+#define CRTC_CURSOR_END     0x0b
+#define CRTC_START_HIGH     0x0c
+#define CRTC_START_LOW      0x0d
+#define CRTC_CURSOR_HIGH    0x0e
+#define CRTC_CURSOR_LOW     0x0f
+
+#define CURSOR_DISABLE      0x20
+
+namespace io
+{
+  namespace crtc
+  {
+    /* Writes a single CRTC register */
+    static void write(uint8_t reg, uint8_t value)
+    {
+      ports::out_8(CRTC_INDEX, reg);
+      ports::out_8(CRTC_DATA, value);
+    }
+
+    /* Reads a single CRTC register */
+    static uint8_t read(uint8_t reg)
+    {
+      ports::out_8(CRTC_INDEX, reg);
+      return ports::in_8(CRTC_DATA);
+    }
+
+    /** Display start */
+    void set_start(uint16_t offset)
+    {
+      write(CRTC_START_HIGH, offset >> 8);
+      write(CRTC_START_LOW, offset & 0xff);
+    }
+
+    /** Cursor location */
+    void set_cursor(uint16_t offset)
+    {
+      write(CRTC_CURSOR_HIGH, offset >> 8);
+      write(CRTC_CURSOR_LOW, offset & 0xff);
+    }
+
+    /** Cursor shape (the upper bits of both registers are preserved) */
+    void show_cursor(uint8_t first, uint8_t last)
+    {
+      write(CRTC_CURSOR_START, (read(CRTC_CURSOR_START) & 0xc0) | (first & 0x1f));
+      write(CRTC_CURSOR_END, (read(CRTC_CURSOR_END) & 0xe0) | (last & 0x1f));
+    }
+
+    /** Cursor disable */
+    void hide_cursor()
+    {
+      write(CRTC_CURSOR_START, read(CRTC_CURSOR_START) | CURSOR_DISABLE);
+    }
+  }
+}
@@ -0,0 +1,173 @@
+#include "exceptions"
+
+/* Kernel */
+#include "interrupts"
+
+/* IO */
+#include <serial>
+#include <vga_screen>
+
+/* STL */
+#include <array>
+
+/* APEX */
+#include <helpers>
+#include <stack_string>
+
+/* Exception names, by vector */
+static constexpr std::array<char const*, 32> names =
+{
+  "#DE Divide Error",
+  "#DB Debug",
+  "NMI Non-Maskable Interrupt",
+  "#BP Breakpoint",
+  "#OF Overflow",
+  "#BR Bound Range Exceeded",
+  "#UD Invalid Opcode",
+  "#NM Device Not Available",
+  "#DF Double Fault",
+  "Coprocessor Segment Overrun",
+  "#TS Invalid TSS",
+  "#NP Segment Not Present",
+  "#SS Stack-Segment Fault",
+  "#GP General Protection Fault",
+  "#PF Page Fault",
+  "Reserved",
+  "#MF x87 Floating-Point Exception",
+  "#AC Alignment Check",
+  "#MC Machine Check",
+  "#XM SIMD Floating-Point Exception",
+  "#VE Virtualization Exception",
+  "#CP Control Protection Exception",
+  "Reserved",
+  "Reserved",
+  "Reserved",
+  "Reserved",
+  "Reserved",
+  "Reserved",
+  "#HV Hypervisor Injection",
+  "#VC VMM Communication",
+  "#SX Security Exception",
+  "Reserved",
+};
+
+/* The number of return addresses shown in the stack walk */
+static constexpr unsigned int max_frames = 16;
+
+/* The crash screen and its manager (nullptr until attached) */
+static io::screen::vga_manager* crash_manager;
+static io::screen::vga_screen* crash_screen;
+
+/* Set while dumping, so a fault during the dump doesn't recurse */
+static bool dumping;
+
+/* Formats a value as hex through stack_string's pointer formatting */
+static void* hex(uint32_t v)
+{ return reinterpret_cast<void*>(v); }
+
+/* Line outputs */
+static void serial_line(apex::stack_string const& line)
+{
+  io::serial::write(line);
+  io::serial::write("\n");
+}
+
+static void screen_line(apex::stack_string const& line)
+{
+  crash_screen->write(line);
+  crash_screen->write("\n");
+}
+
+/* Reads the page fault linear address */
+static uint32_t read_cr2()
+{
+  uint32_t cr2;
+  asm volatile("mov %%cr2, %0" : "=r"(cr2));
+  return cr2;
+}
+
+/* Prints the return addresses in the ebp chain */
+static void stack_walk(uint32_t ebp, void(*print)(apex::stack_string const&))
+{
+  print("Stack trace:");
+
+  for(unsigned int i = 0; i < max_frames; ++i)
+  {
+    /* The boot code zeroes ebp, which ends the chain */
+    if(!ebp || (ebp & 3))
+      break;
+
+    uint32_t const* frame = reinterpret_cast<uint32_t const*>(ebp);
+    print(apex::stack_string("  ") + hex(frame[1]));
+
+    /* Frames only grow toward higher addresses */
+    if(frame[0] <= ebp)
+      break;
+    ebp = frame[0];
+  }
+}
+
+/* Prints the registers and the stack walk */
+static void dump(interrupts::interrupt_frame const& frame, void(*print)(apex::stack_string const&))
+{
+  /* The interrupted esp is just past the cpu-pushed eip, cs, and eflags */
+  uint32_t esp = frame.esp + 5 * sizeof(uint32_t);
+
+  print(apex::stack_string("*** ") + names[frame.vector] + " at " + hex(frame.eip) + " ***");
+  print(apex::stack_string("vector ") + frame.vector + "  error " + hex(frame.error_code) + "  cr2 " + hex(read_cr2()));
+  print(apex::stack_string("eax ") + hex(frame.eax) + "  ebx " + hex(frame.ebx) + "  ecx " + hex(frame.ecx) + "  edx " + hex(frame.edx));
+  print(apex::stack_string("esi ") + hex(frame.esi) + "  edi " + hex(frame.edi) + "  ebp " + hex(frame.ebp) + "  esp " + hex(esp));
+  print(apex::stack_string("cs ") + hex(frame.cs) + "  eflags " + hex(frame.eflags));
+  stack_walk(frame.ebp, print);
+}
+
+/* The handler for every exception vector */
+static void exception_handler(interrupts::interrupt_frame& frame)
+{
+  /* A fault while dumping -- give up */
+  if(dumping)
+    apex::__break();
+  dumping = true;
+
+  /* Serial first -- it doesn't allocate, so it works even if the heap is what broke */
+  dump(frame, &serial_line);
+
+  /* Switching screens doesn't allocate either, but it's the less important copy */
+  io::screen::vga_screen* previous = nullptr;
+  if(crash_manager)
+  {
+    previous = crash_manager->get_active();
+    crash_manager->set_active(*crash_screen);
+    dump(frame, &screen_line);
+  }
+
+  /* Breakpoints are the only exception worth continuing from -- put the screens back */
+  if(frame.vector == 3)
+  {
+    if(crash_manager)
+    {
+      crash_manager->lower(*crash_screen);
+      crash_manager->set_active(previous);
+    }
+
+    dumping = false;
+    return;
+  }
+
+  apex::__break();
+}
+
+/* Exception setup */
+void exceptions::setup()
+{
+  for(uint8_t vec = 0; vec < names.size(); ++vec)
+    interrupts::add(vec, &exception_handler, true);
+}
+
+/* Crash screen setup */
+void exceptions::attach_screen(io::screen::vga_manager& manager)
+{
+  crash_screen = &manager.create_screen({0,0}, {manager.get_width(), manager.get_height()}, "Crash");
+  crash_screen->push_attrib({io::screen::color::WHITE, io::screen::color::RED});
+  crash_manager = &manager;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace io
+{
+  namespace screen
+  { class vga_manager; }
+}
+
+/**
+ * Handlers for the CPU exceptions (vectors 0-31)
+ *
+ * An exception dumps the registers, CR2, and a frame-pointer stack walk
+ * to the serial port (and the crash screen, once one is attached), then halts.
+ * Breakpoints (#BP) dump and resume.
+ */
+namespace exceptions
+{
+  /**
+   * Registers handlers for vectors 0-31
+   * Requires interrupts::setup() and io::serial::initialize()
+   */
+  void setup();
+
+  /**
+   * Creates the (inactive) crash screen on the given manager
+   * It's created up front so a crash doesn't depend on the heap
+   *
+   * @param manager   The manager to create the screen on
+   */
+  void attach_screen(io::screen::vga_manager& manager);
+}
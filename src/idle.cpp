@@ -0,0 +1,85 @@
+#include "idle"
+
+/* Kernel */
+#include "interrupts"
+#include "pit"
+#include "timers"
+
+/* STL */
+#include <array>
+
+/* APEX */
+#include <clock>
+#include <helpers>
+
+/* The registered work functions */
+static std::array<idle::work_func, idle::max_work> work;
+static unsigned int work_count;
+
+/* Set by wake(), cleared before each pass over the work */
+static volatile bool woken;
+
+/* Accounting, in TSC ticks */
+static uint64_t start_tsc;
+static uint64_t idle_tsc;
+static uint32_t wakeup_count;
+
+/* Work registration */
+void idle::add_work(work_func f)
+{
+  if(work_count >= work.size())
+    apex::__break();
+
+  work[work_count++] = f;
+}
+
+/* Wake request */
+void idle::wake()
+{ woken = true; }
+
+/* The idle loop */
+void idle::run()
+{
+  start_tsc = apex::clock::rdtsc();
+
+  for(;;)
+  {
+    woken = false;
+    for(unsigned int i = 0; i < work_count; ++i)
+      work[i]();
+
+    /* Check for new work with interrupts off, so nothing can slip in before the hlt */
+    interrupts::disable_hw_interrupts();
+    if(woken)
+    {
+      interrupts::enable_hw_interrupts();
+      continue;
+    }
+
+    /* Tickless -- the only timer interrupt is a one-shot for the next deadline */
+    uint64_t deadline = timers::next_deadline();
+    if(deadline != UINT64_MAX)
+      pit::set_deadline(deadline);
+
+    /* sti's one instruction delay means the hlt can't miss an interrupt */
+    uint64_t halt_tsc = apex::clock::rdtsc();
+    uint64_t halt_handlers = interrupts::handler_ticks();
+    asm volatile("sti; hlt" ::: "memory");
+
+    /* The wakeup's handlers ran before hlt returned, but weren't idle */
+    uint64_t busy = interrupts::handler_ticks() - halt_handlers;
+    uint64_t halted = apex::clock::rdtsc() - halt_tsc;
+    idle_tsc += halted > busy ? halted - busy : 0;
+    ++wakeup_count;
+  }
+}
+
+/* Accounting */
+idle::stats_t idle::stats()
+{
+  stats_t s;
+  s.idle_ns = apex::clock::to_ns(idle_tsc);
+  s.total_ns = start_tsc ? apex::clock::to_ns(apex::clock::rdtsc() - start_tsc) : 0;
+  s.wakeups = wakeup_count;
+  return s;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * The kernel's idle loop
+ *
+ * Runs the registered work functions, then halts until the next interrupt.
+ * Interrupts are disabled between the final check for work and the hlt
+ *   (sti only takes effect after the following instruction), so an interrupt
+ *   that calls wake() can never be missed.
+ *
+ * The halt is tickless: it arms a PIT one-shot for timers::next_deadline(),
+ *   and otherwise sleeps until some other interrupt arrives.
+ */
+namespace idle
+{
+  /** Signature for a work function, run after every wakeup */
+  using work_func = void(*)();
+
+  /* The maximum number of work functions */
+  constexpr unsigned int max_work = 8;
+
+  /**
+   * Registers a function to run after every wakeup
+   * (i.e. timers::run)
+   */
+  void add_work(work_func f);
+
+  /**
+   * Requests another pass over the work functions before halting
+   * Safe to call from interrupt context
+   */
+  void wake();
+
+  /**
+   * Runs the idle loop forever
+   * Requires interrupts to be set up
+   */
+  [[noreturn]] void run();
+
+  /**
+   * @struct stats_t
+   * @brief Idle time accounting since run() was called
+   */
+  struct stats_t
+  {
+    /** @brief Time spent halted, less the interrupt handlers that woke it */
+    uint64_t idle_ns;
+    /** @brief Total time */
+    uint64_t total_ns;
+    /** @brief The number of times the cpu woke up from hlt */
+    uint32_t wakeups;
+  };
+
+  /**
+   * @return The current idle accounting
+   */
+  stats_t stats();
+}
@@ -0,0 +1,120 @@
+#include "interrupt_stats"
+
+/* Kernel */
+#include "interrupts"
+#include "timers"
+
+/* IO */
+#include <serial>
+#include <vga_screen>
+
+/* APEX */
+#include <clock>
+#include <stack_string>
+
+/* Histogram buckets per output line */
+static constexpr unsigned int buckets_per_line = 4;
+
+/* Refreshes between serial logs */
+static constexpr unsigned int refreshes_per_log = 10;
+
+/* The statistics screen (nullptr until started) */
+static io::screen::vga_screen* stats_screen;
+
+/* The screen being printed to */
+static io::screen::vga_screen* print_screen;
+
+/* Large values are only expected to be nonsense, so clamp them for display */
+static uint32_t clamp(uint64_t v)
+{ return v > 0xffffffff ? 0xffffffff : static_cast<uint32_t>(v); }
+
+/* Line outputs */
+static void screen_line(apex::stack_string const& line)
+{
+  print_screen->write(line);
+  print_screen->write("\n");
+}
+
+static void serial_line(apex::stack_string const& line)
+{
+  io::serial::write(line);
+  io::serial::write("\n");
+}
+
+/* Builds the report a line at a time */
+static void report(void(*line)(apex::stack_string const&))
+{
+  line("vector  count       max (ns)");
+
+  for(unsigned int vec = 0; vec < 256; ++vec)
+  {
+    interrupts::vector_stats s = interrupts::get_stats(vec);
+    if(!s.count)
+      continue;
+
+    line(apex::stack_string("") + vec + "  " + s.count + "  " + clamp(apex::clock::to_ns(s.max_ticks)));
+
+    /* "<limit_ns:count" for each non-empty bucket */
+    apex::stack_string buckets("   ");
+    unsigned int on_line = 0;
+    for(unsigned int b = 0; b < interrupts::histogram_buckets; ++b)
+    {
+      if(!s.histogram[b])
+        continue;
+
+      if(b + 1 < interrupts::histogram_buckets)
+        buckets += apex::stack_string(" <") + clamp(apex::clock::to_ns(interrupts::bucket_limit(b))) + ":" + s.histogram[b];
+      else
+        buckets += apex::stack_string(" more:") + s.histogram[b];
+
+      if(++on_line == buckets_per_line)
+      {
+        line(buckets);
+        buckets = apex::stack_string("   ");
+        on_line = 0;
+      }
+    }
+
+    if(on_line)
+      line(buckets);
+  }
+}
+
+/* Screen output */
+void interrupt_stats::print(io::screen::vga_screen& screen)
+{
+  print_screen = &screen;
+  report(&screen_line);
+  print_screen = nullptr;
+}
+
+/* Serial output */
+void interrupt_stats::log()
+{
+  serial_line("--- interrupt statistics ---");
+  report(&serial_line);
+}
+
+/* Periodic refresh */
+static void refresh(timers::timer&)
+{
+  static unsigned int refreshes;
+
+  stats_screen->clear();
+  interrupt_stats::print(*stats_screen);
+
+  if(++refreshes == refreshes_per_log)
+  {
+    interrupt_stats::log();
+    refreshes = 0;
+  }
+}
+
+static timers::timer refresh_timer(&refresh);
+
+/* Setup */
+void interrupt_stats::start(io::screen::vga_manager& manager)
+{
+  stats_screen = &manager.create_screen({0,0}, {manager.get_width(), manager.get_height()}, "Interrupts");
+  timers::start(refresh_timer, 1000000000, 1000000000);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+namespace io
+{
+  namespace screen
+  {
+    class vga_manager;
+    class vga_screen;
+  }
+}
+
+/**
+ * Reports the per-vector interrupt counters (see interrupts::get_stats)
+ *
+ * Each vector that has fired gets its count, slowest handler,
+ *   and the non-empty buckets of its handler duration histogram
+ *   (labelled with each bucket's upper bound).
+ */
+namespace interrupt_stats
+{
+  /**
+   * Writes the report to a screen
+   */
+  void print(io::screen::vga_screen& screen);
+
+  /**
+   * Writes the report to the serial port
+   */
+  void log();
+
+  /**
+   * Creates an "Interrupts" screen, redrawn every second,
+   *   and logs the report to serial every 10 seconds
+   * Requires the idle loop to run timers
+   *
+   * @param manager   The manager to create the screen on
+   */
+  void start(io::screen::vga_manager& manager);
+}
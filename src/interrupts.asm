@@ -44,18 +44,56 @@ disable_hw_interrupts:
   cli
   ret
 
-; @func void int_wrapper
-; A function that can be used to generate
-; interrupt wrapper code for C/C++ functions
-global int_wrapper_f
-int_wrapper_f:
-  push .return
-  jmp 0x8:0xdeadc0de
-  .return:
+; ##################
+; Interrupt entry
+; ##################
+
+; Vectors where the CPU pushes an error code itself
+%define HAS_ERROR_CODE(v) ((v) == 8 || ((v) >= 10 && (v) <= 14) || (v) == 17 || (v) == 21 || (v) == 29 || (v) == 30)
+
+; @func isr_stub_N
+; One entry stub per vector, each pushes a (dummy, if needed)
+; error code and its vector so every frame has the same layout
+%assign vec 0
+%rep 256
+isr_stub_%+vec:
+%if HAS_ERROR_CODE(vec) == 0
+  push dword 0
+%endif
+  push dword vec
+  jmp isr_common
+%assign vec vec+1
+%endrep
+
+; @func isr_common
+; Saves the interrupted registers, builds an interrupts::interrupt_frame
+; on the stack and hands it to isr_dispatch
+extern isr_dispatch
+isr_common:
+  pushad
+  cld
+
+  ; Pass the frame
+  push esp
+  call isr_dispatch
+  add esp, 4
+
+  ; Restore registers, pop the vector and error code
+  popad
+  add esp, 8
   iret
-  .end:
 
-; @uint32_t int_wrapper_size
-; The size of the int_wrapper function
-global int_wrapper_s
-int_wrapper_s: dd (int_wrapper_f.end - int_wrapper_f)
+; ##################
+; Interrupt tables
+; ##################
+section .rodata
+
+; @uint32_t isr_stub_table[256]
+; The address of each vector's stub
+global isr_stub_table
+isr_stub_table:
+%assign vec 0
+%rep 256
+  dd isr_stub_%+vec
+%assign vec vec+1
+%endrep
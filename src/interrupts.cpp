@@ -2,27 +2,31 @@
 
 #include <array>
 #include <cstddef>
-#include <cstdlib>
-#include <cstring>
 #include <stdint.h>
 
+/* APEX */
+#include <clock>
+#include <helpers>
+#include <handler_chain>
+
 /* An entry in the IDT */
 struct idt_entry
 {
-  idt_entry()
+  constexpr idt_entry()
   :addr_low(0)
   ,code_selector(0)
   ,zero(0)
+  ,attr()
   ,addr_high(0)
   { }
 
   /* Manages the attribute fields */
   union attrib_t
   {
-    /* Default to not present */
-    attrib_t()
-    :raw(0)
-    { one = 1; }
+    /* Default to not present (only the 'one' bit set) */
+    constexpr attrib_t()
+    :raw(1 << 2)
+    { }
 
     /* The fields */
     struct
@@ -46,55 +50,94 @@ struct idt_entry
   uint16_t addr_high;
 };
 
-/* The IDT */
+/* The IDT -- constant-initialized, so it's ready before any constructors run */
 static std::array<idt_entry, 256> idt;
 
-/* Declarations for functions in int.asm */
+/* The handlers for each vector */
+static apex::handler_chain<interrupts::int_func> chains[256];
+
+/* True if any chain has retired lists to reclaim */
+static bool needs_reclaim;
+
+/* The counters for each vector */
+static interrupts::vector_stats stats[256];
+
+/* The time spent in all handlers */
+static uint64_t total_ticks;
+
+/* Disables interrupts, returning the old eflags */
+static uint32_t save_and_disable()
+{
+  uint32_t eflags;
+  asm volatile("pushf; pop %0; cli" : "=r"(eflags) : : "memory");
+  return eflags;
+}
+
+/* Re-enables interrupts if they were enabled in eflags */
+static void restore(uint32_t eflags)
+{
+  if(eflags & 0x200)
+    asm volatile("sti" : : : "memory");
+}
+
+/* Declarations for functions in interrupts.asm */
 extern "C"
 {
   void load_idt(void*);
 
-  void int_wrapper_f();
-  extern uint32_t int_wrapper_s;
+  extern uint32_t const isr_stub_table[256];
+
+  /* Called by isr_common for every interrupt */
+  void isr_dispatch(interrupts::interrupt_frame* frame)
+  {
+    interrupts::vector_stats& s = stats[frame->vector];
+    ++s.count;
+
+    auto const* handlers = chains[frame->vector].read();
+    if(!handlers)
+      return;
+
+    /* Handlers run with interrupts off, so this is also the interrupt-off time */
+    uint64_t start = apex::clock::rdtsc();
+    for(auto const& h : *handlers)
+      h.handler(*frame);
+    uint64_t ticks = apex::clock::rdtsc() - start;
+    total_ticks += ticks;
+
+    if(ticks > s.max_ticks)
+      s.max_ticks = ticks;
+
+    /* Bucket by the highest set bit */
+    uint64_t scaled = ticks >> interrupts::histogram_shift;
+    unsigned int bucket = interrupts::histogram_buckets - 1;
+    if(scaled <= 0xffffffff)
+    {
+      uint32_t s32 = static_cast<uint32_t>(scaled);
+      unsigned int log2 = s32 ? 31 - __builtin_clz(s32) : 0;
+      if(log2 < bucket)
+        bucket = log2;
+    }
+    ++s.histogram[bucket];
+  }
 }
 
 /* Blank interrupt setup */
 void interrupts::setup()
 {
-  /* Initialize table */
-  for(idt_entry& ie : idt)
-    ie = idt_entry();
-
   /* Submit idt */
   load_idt(idt.data());
 }
 
 /* Interrupt registration */
-void interrupts::add(uint8_t vec, int_func func, bool is_int)
+void interrupts::add(uint8_t vec, int_func func, bool is_int, int priority)
 {
-  /* Create a new callback handler */
-  char* wrapper = new char[int_wrapper_s];
-
-  /* Awwww yeah -- it's not every day you get to cast
-     a function pointer to a char pointer! :D */
-  char* origin_wrapper = reinterpret_cast<char*>(&int_wrapper_f);
+  /* Add the handler before the vector can fire */
+  if(!chains[vec].add(func, priority))
+    apex::__break();
+  needs_reclaim = true;
 
-  /* Copy wrapper */
-  std::memcpy(wrapper, origin_wrapper, int_wrapper_s);
-
-  /* Replace 0xdeadc0de with our code! */
-  uint32_t indx = 0;
-  while(wrapper[indx+0] != char(0xde) ||
-        wrapper[indx+1] != char(0xc0) ||
-        wrapper[indx+2] != char(0xad) ||
-        wrapper[indx+3] != char(0xde))
-    indx++;
-
-  /* And you thought the reinterpret cast was bad xD */
-  std::memcpy(wrapper+indx, &func, 4);
-
-  /* Setup the idt "normally" */
-  uint32_t call = reinterpret_cast<uint32_t>(wrapper);
+  /* Point the idt at the vector's stub */
+  uint32_t call = isr_stub_table[vec];
   idt_entry& int_handle = idt[vec];
 
   int_handle.addr_low = static_cast<uint32_t>(call & 0xffff);
@@ -110,15 +153,68 @@ void interrupts::add(uint8_t vec, int_func func, bool is_int)
   return;
 }
 
+/* De-register a handler */
+void interrupts::remove(uint8_t vec, int_func func)
+{
+  if(!chains[vec].remove(func))
+    return;
+
+  if(chains[vec].empty())
+    idt[vec] = {};
+
+  needs_reclaim = true;
+}
+
 /* De-register interrupt */
 void interrupts::remove(uint8_t vec)
 {
-  idt_entry& int_handle = idt[vec];
+  idt[vec] = {};
+  chains[vec].clear();
+  needs_reclaim = true;
+}
+
+/* Registration status */
+bool interrupts::is_registered(uint8_t vec)
+{
+  return !chains[vec].empty();
+}
+
+/* Free replaced handler lists */
+void interrupts::reclaim()
+{
+  if(!needs_reclaim)
+    return;
 
-  uint32_t call = static_cast<uint32_t>(int_handle.addr_high) << 16 |
-                  static_cast<uint32_t>(int_handle.addr_low);
+  needs_reclaim = false;
+  for(auto& chain : chains)
+    chain.reclaim();
+}
+
+/* Counters */
+interrupts::vector_stats interrupts::get_stats(uint8_t vec)
+{
+  uint32_t eflags = save_and_disable();
+  vector_stats s = stats[vec];
+  restore(eflags);
+  return s;
+}
+
+uint64_t interrupts::max_latency(uint8_t vec)
+{
+  return apex::clock::to_ns(get_stats(vec).max_ticks);
+}
 
-  delete[] reinterpret_cast<char*>(call);
+void interrupts::reset_stats(uint8_t vec)
+{
+  uint32_t eflags = save_and_disable();
+  stats[vec] = {};
+  restore(eflags);
+}
 
-  int_handle = {};
+uint64_t interrupts::handler_ticks()
+{
+  uint32_t eflags = save_and_disable();
+  uint64_t ticks = total_ticks;
+  restore(eflags);
+  return ticks;
 }
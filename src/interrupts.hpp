@@ -22,25 +22,114 @@ namespace interrupts
    */
   void setup();
 
+  /**
+   * The state saved on entry to every interrupt
+   * (built by isr_common and the per-vector stubs in interrupts.asm)
+   *
+   * Handlers may modify the registers, they're restored on return
+   */
+  struct interrupt_frame
+  {
+    /* Pushed by pushad (esp is its value before the pushad) */
+    uint32_t edi, esi, ebp, esp, ebx, edx, ecx, eax;
+
+    /* Pushed by the stub */
+    uint32_t vector;
+    uint32_t error_code;    /* 0 for vectors without one */
+
+    /* Pushed by the CPU */
+    uint32_t eip, cs, eflags;
+  };
+
   /**
    * The signature for an interrupt function
    */
-  using int_func = void(*)(void);
+  using int_func = void(*)(interrupt_frame&);
 
   /**
-   * Registers a given interrupt or trap
+   * Registers a handler for a given interrupt or trap
    *
+   * Vectors can be shared: every handler on a vector runs on each interrupt,
+   *   highest priority first (same priorities in the order they were added)
    * Interrupts disable hw interrupts while processing
    * Traps do not
    *
+   * Registration allocates, so don't call add/remove from interrupt context
+   *
    * @param vec       The interrupt vector to setup
    * @param func      Function to call for interrupt
    * @param is_int    True for an interrupt gate, false for trap
+   * @param priority  Higher priorities run first
    */
-  void add(uint8_t vec, int_func func, bool is_int);
+  void add(uint8_t vec, int_func func, bool is_int, int priority = 0);
 
   /**
-   * De-registers the given interrupt vector
+   * De-registers a single handler, the vector is disabled when its last handler is removed
+   */
+  void remove(uint8_t vec, int_func func);
+
+  /**
+   * De-registers every handler on the given interrupt vector
    */
   void remove(uint8_t vec);
+
+  /**
+   * @return True if the vector has any handlers
+   */
+  bool is_registered(uint8_t vec);
+
+  /**
+   * Frees handler lists replaced by add/remove
+   * Handlers can still be running on a replaced list until the interrupt
+   *   returns, so this must be called from outside any handler (i.e. idle work)
+   */
+  void reclaim();
+
+  /**
+   * Handler durations are histogrammed in power-of-two TSC tick buckets
+   * Bucket b holds [2^(b + shift), 2^(b + shift + 1)) ticks,
+   *   except the first, which starts at 0, and the last, which has no end
+   */
+  constexpr unsigned int histogram_buckets = 16;
+  constexpr unsigned int histogram_shift = 6;
+
+  /* The (exclusive) upper bound of a bucket, in TSC ticks */
+  constexpr uint64_t bucket_limit(unsigned int bucket)
+  { return static_cast<uint64_t>(1) << (bucket + histogram_shift + 1); }
+
+  /**
+   * @struct vector_stats
+   * @brief Counters for a single vector, recorded by the common dispatch path
+   */
+  struct vector_stats
+  {
+    /** @brief Times the vector fired (including with no handler) */
+    uint32_t count;
+    /** @brief The longest its handler has run (with interrupts off), in TSC ticks */
+    uint64_t max_ticks;
+    /** @brief Handler durations */
+    uint32_t histogram[histogram_buckets];
+  };
+
+  /**
+   * @param vec   The interrupt vector
+   * @return A consistent copy of its counters
+   */
+  vector_stats get_stats(uint8_t vec);
+
+  /**
+   * @param vec   The interrupt vector
+   * @return The longest its handler has run (with interrupts off), in ns
+   */
+  uint64_t max_latency(uint8_t vec);
+
+  /**
+   * Resets the vector's counters to 0
+   */
+  void reset_stats(uint8_t vec);
+
+  /**
+   * @return The time spent in handlers on every vector since boot, in TSC ticks
+   */
+  uint64_t handler_ticks();
 }
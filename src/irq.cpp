@@ -0,0 +1,113 @@
+#include "irq"
+
+/* Kernel */
+#include "apic"
+#include "pic"
+
+/* APEX */
+#include <handler_chain>
+#include <helpers>
+
+/* True if the APIC is in use */
+static bool apic_mode;
+
+/* Allocated dynamic vectors, one bit each */
+static uint32_t vector_map[256 / 32];
+
+/* The handlers of each ISA line */
+static apex::handler_chain<interrupts::int_func, irq::max_line_handlers> lines[16];
+
+/* Signals the end of an ISA IRQ */
+static void eoi(uint8_t isa_irq)
+{
+  if(apic_mode)
+    apic::eoi();
+  else
+    pic::acknowledge(static_cast<uint16_t>(1 << isa_irq));
+}
+
+/* The handler on every ISA vector -- runs the line's handlers, then ends the interrupt */
+static void line_handler(interrupts::interrupt_frame& frame)
+{
+  uint8_t isa_irq = frame.vector - irq::isa_base;
+
+  if(auto const* handlers = lines[isa_irq].read())
+    for(auto const& h : *handlers)
+      h.handler(frame);
+
+  eoi(isa_irq);
+}
+
+/* Controller setup */
+void irq::initialize()
+{
+  apic_mode = apic::initialize();
+
+  /* The APIC replaces the PIC entirely */
+  if(apic_mode)
+    pic::mask(pic::irq_t::ALL);
+}
+
+/* Mode */
+bool irq::using_apic()
+{ return apic_mode; }
+
+/* Handler installation */
+void irq::install(uint8_t isa_irq, interrupts::int_func func, int priority)
+{
+  bool first = lines[isa_irq].empty();
+  if(!lines[isa_irq].add(func, priority))
+    apex::__break();
+
+  /* Installing never runs inside a handler, so nothing can hold the old snapshot */
+  lines[isa_irq].reclaim();
+
+  if(!first)
+    return;
+
+  uint8_t vector = isa_base + isa_irq;
+  interrupts::add(vector, &line_handler, true);
+
+  if(apic_mode)
+    apic::route_isa(isa_irq, vector);
+  else
+    pic::unmask(static_cast<uint16_t>(1 << isa_irq));
+}
+
+/* Handler removal */
+void irq::uninstall(uint8_t isa_irq, interrupts::int_func func)
+{
+  if(!lines[isa_irq].remove(func))
+    return;
+  lines[isa_irq].reclaim();
+
+  if(!lines[isa_irq].empty())
+    return;
+
+  uint8_t vector = isa_base + isa_irq;
+  interrupts::remove(vector, &line_handler);
+
+  if(apic_mode)
+    apic::mask_isa(isa_irq);
+  else
+    pic::mask(static_cast<uint16_t>(1 << isa_irq));
+}
+
+/* Vector allocation */
+uint8_t irq::allocate_vector()
+{
+  for(uint32_t v = first_dynamic; v <= last_dynamic; ++v)
+  {
+    uint32_t bit = 1u << (v % 32);
+    if(!(vector_map[v / 32] & bit))
+    {
+      vector_map[v / 32] |= bit;
+      return static_cast<uint8_t>(v);
+    }
+  }
+
+  return 0;
+}
+
+void irq::free_vector(uint8_t vector)
+{ vector_map[vector / 32] &= ~(1u << (vector % 32)); }
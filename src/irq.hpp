@@ -0,0 +1,69 @@
+#pragma once
+
+/* Kernel */
+#include "interrupts"
+
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * Hardware IRQ management over the I/O APIC, or the 8259 PIC when there isn't one
+ *
+ * ISA IRQ n is always delivered on vector isa_base + n,
+ *   other vectors are handed out by allocate_vector (i.e. for MSIs).
+ *
+ * Each ISA line has a single handler on its vector, which runs the line's
+ *   handlers then signals the end of the interrupt, so drivers never do.
+ */
+namespace irq
+{
+  /* The vector of ISA IRQ 0 */
+  constexpr uint8_t isa_base = 0x20;
+
+  /* The range of allocatable vectors [first, last] */
+  constexpr uint8_t first_dynamic = 0x30;
+  constexpr uint8_t last_dynamic = 0xfe;
+
+  /**
+   * Picks and sets up the interrupt controller
+   * Requires pic::initialize() (the PIC is remapped and masked either way)
+   */
+  void initialize();
+
+  /**
+   * @return True if IRQs are going through the APIC
+   */
+  bool using_apic();
+
+  /* The most handlers sharing one ISA line */
+  constexpr unsigned int max_line_handlers = 8;
+
+  /**
+   * Installs a handler for an ISA IRQ, then unmasks it
+   * Lines can be shared, every handler runs on each interrupt
+   * Don't call from interrupt context
+   *
+   * @param isa_irq   The legacy IRQ (0-15)
+   * @param func      The handler (the end of interrupt is signalled after the last handler)
+   * @param priority  Higher priorities run first
+   */
+  void install(uint8_t isa_irq, interrupts::int_func func, int priority = 0);
+
+  /**
+   * Removes a handler from an ISA IRQ, masking the IRQ if it was the last one
+   * Don't call from interrupt context
+   */
+  void uninstall(uint8_t isa_irq, interrupts::int_func func);
+
+  /**
+   * Reserves a free vector
+   *
+   * @return The vector, or 0 if none are left
+   */
+  uint8_t allocate_vector();
+
+  /**
+   * Releases a vector from allocate_vector
+   */
+  void free_vector(uint8_t vector);
+}
@@ -1,13 +1,24 @@
 /* Kernel */
+#include "acpi"
+#include "exceptions"
+#include "idle"
+#include "interrupt_stats"
+#include "irq"
+#include "klog"
+#include "lfb"
 #include "mem_manager"
 #include "multiboot2"
 #include "page_manager"
 #include "pic"
+#include "pit"
 #include "ports"
 #include "interrupts"
+#include "softirq"
+#include "timers"
 
 /* IO */
 #include <keyboard>
+#include <serial>
 #include <vga_screen>
 
 /* STL */
@@ -17,6 +28,7 @@
 #include <vector>
 
 /* APEX */
+#include <clock>
 #include <helpers>
 #include <stack_string>
 
@@ -66,6 +78,17 @@ extern "C" void kernel_init(page_manager::page_directory* page_dir, const multib
         }
       }
       break;
+
+    case 14:
+    case 15:
+      /* Remember the ACPI tables */
+      acpi::set_rsdp(reinterpret_cast<const multiboot2::tag_acpi_rsdp*>(tag)->rsdp());
+      break;
+
+    case 8:
+      /* Remember the framebuffer (if it isn't text mode) */
+      lfb::set_framebuffer(reinterpret_cast<const multiboot2::tag_framebuffer*>(tag));
+      break;
     }
   }
 
@@ -82,14 +105,31 @@ extern "C" void kernel_init(page_manager::page_directory* page_dir, const multib
  * Second-round init function, happens after _init
  *
  * Initializes
- * - Interrupts/PIC
+ * - Serial
+ * - Interrupts/PIC/APIC
+ * - CPU exception handlers
+ * - Clock/PIT
  */
 extern "C" void kernel_init2()
 {
-  /* Setup interrupts */
+  /* Setup serial (for crash dumps, and the log) */
+  io::serial::initialize();
+  klog::attach_serial();
+
+  /* Setup interrupts -- remap the PIC first, so IRQs can't land on exception vectors */
   interrupts::setup();
-  interrupts::enable_hw_interrupts();
+  exceptions::setup();
   pic::initialize();
+  irq::initialize();
+
+  /* Serial output is interrupt-driven from here on */
+  io::serial::enable();
+
+  /* Setup the clock, then the (tickless) timer interrupt */
+  apex::clock::calibrate(pit::calibrate_tsc());
+  pit::initialize();
+
+  interrupts::enable_hw_interrupts();
 }
 
 /**
@@ -100,17 +140,28 @@ extern "C" void kernel_init2()
  */
 extern "C" int kernel_main()
 {
-  /* Setup Screen */
-  io::screen::vga_manager manager({80,25});
-  io::screen::vga_screen& debug_screen = manager.create_screen({0,0}, {80,25}, "Debug");
+  /* Setup Screen -- on the framebuffer if there is one, else VGA text mode */
+  const io::screen::cell_display* display = lfb::console();
+  io::screen::vga_manager manager = display ? io::screen::vga_manager(*display) : io::screen::vga_manager({80,25});
+  io::screen::vga_screen& debug_screen = manager.create_screen({0,0}, {manager.get_width(), manager.get_height()}, "Debug");
+  debug_screen.set_scrollback(1000);
   manager.set_active(debug_screen);
+  klog::attach_screen(debug_screen);
+  klog::info(apex::stack_string(display ? "Framebuffer console " : "VGA text console ")
+             + static_cast<uint32_t>(manager.get_width()) + "x" + static_cast<uint32_t>(manager.get_height()));
+  exceptions::attach_screen(manager);
+  interrupt_stats::start(manager);
 
   /* Setup Keyboard */
   io::keyboard::enable();
   io::keyboard::register_callback(&io::screen::vga_manager::global_event);
 
-  /* Hang w/ interrupts */
-  for(;;);
+  /* Idle forever, running bottom halves and timers after every wakeup */
+  idle::add_work(&softirq::run);
+  idle::add_work(&timers::run);
+  idle::add_work(&klog::drain);
+  idle::add_work(&interrupts::reclaim);
+  idle::run();
 
   /* Success! */
   return 0;
@@ -1,67 +1,218 @@
 /* Kernel */
 #include "interrupts"
+#include "irq"
 #include "ports"
-#include "pic"
+#include "softirq"
 
 /* IO */
 #include <keyboard>
 
 /* STL */
-#include <vector>
+#include <array>
+
+/* APEX */
+#include <handler_chain>
+#include <helpers>
+#include <spsc_ring>
 
 namespace io
 {
   namespace keyboard
   {
     /* Callbacks */
-    static std::vector<event_callback> callbacks;
+    static apex::handler_chain<event_callback, 16> callbacks;
+
+    /* True while the bottom half is running callbacks */
+    static bool dispatching;
+
+    /* A single scancode's translation */
+    struct scancode_entry
+    {
+      key_t key = KEY_NULL;
+      char ascii = 0;
+      char shifted = 0;
+    };
+
+    using scancode_table = std::array<scancode_entry, 0x80>;
+
+    /* Builds the (US QWERTY) scancode set 1 translation table */
+    static constexpr scancode_table make_scancode_table()
+    {
+      scancode_table t{};
+
+      /* Fills consecutive scancodes starting at first */
+      auto row = [&t](uint8_t first, char const* lower, char const* upper, key_t const* keys)
+      {
+        for(uint8_t i = 0; lower[i]; ++i)
+          t[first + i] = {keys[i], lower[i], upper[i]};
+      };
+
+      /* Letters are in alphabetical enum order */
+      auto letters = [&t](uint8_t first, char const* lower)
+      {
+        for(uint8_t i = 0; lower[i]; ++i)
+          t[first + i] = {key_t(KEY_A + (lower[i] - 'a')), lower[i], char(lower[i] - 'a' + 'A')};
+      };
+
+      constexpr key_t digits[] = {KEY_1, KEY_2, KEY_3, KEY_4, KEY_5,
+                                  KEY_6, KEY_7, KEY_8, KEY_9, KEY_0,
+                                  KEY_MINUS, KEY_EQUALS};
+      row(0x02, "1234567890-=", "!@#$%^&*()_+", digits);
+
+      letters(0x10, "qwertyuiop");
+      constexpr key_t brackets[] = {KEY_LBRACKET, KEY_RBRACKET};
+      row(0x1A, "[]", "{}", brackets);
+
+      letters(0x1E, "asdfghjkl");
+      constexpr key_t home_punct[] = {KEY_SEMICOLON, KEY_APOSTROPHE, KEY_GRAVE};
+      row(0x27, ";'`", ":\"~", home_punct);
+
+      letters(0x2C, "zxcvbnm");
+      constexpr key_t bottom_punct[] = {KEY_COMMA, KEY_PERIOD, KEY_SLASH};
+      row(0x33, ",./", "<>?", bottom_punct);
+
+      t[0x01] = {KEY_ESCAPE, 27, 27};
+      t[0x0E] = {KEY_BACKSPACE, '\b', '\b'};
+      t[0x0F] = {KEY_TAB, '\t', '\t'};
+      t[0x1C] = {KEY_ENTER, '\n', '\n'};
+      t[0x2B] = {KEY_BACKSLASH, '\\', '|'};
+      t[0x39] = {KEY_SPACE, ' ', ' '};
+
+      t[0x1D] = {KEY_LCTRL, 0, 0};
+      t[0x2A] = {KEY_LSHIFT, 0, 0};
+      t[0x36] = {KEY_RSHIFT, 0, 0};
+      t[0x38] = {KEY_LALT, 0, 0};
+
+      return t;
+    }
+
+    /* Generated at compile time, lives in .rodata */
+    static constexpr scancode_table scancodes = make_scancode_table();
+    static_assert(scancodes[0x1E].key == KEY_A && scancodes[0x1E].shifted == 'A', "Bad scancode table");
+
+    using extended_table = std::array<key_t, 0x80>;
+
+    /* Builds the translation of 0xE0-prefixed scancodes (the fake shifts stay KEY_NULL) */
+    static constexpr extended_table make_extended_table()
+    {
+      extended_table t{};
 
-    /** Event handling */
-    void int_handler()
+      t[0x1D] = KEY_RCTRL;
+      t[0x38] = KEY_RALT;
+
+      t[0x47] = KEY_HOME;
+      t[0x48] = KEY_UP;
+      t[0x49] = KEY_PAGE_UP;
+      t[0x4B] = KEY_LEFT;
+      t[0x4D] = KEY_RIGHT;
+      t[0x4F] = KEY_END;
+      t[0x50] = KEY_DOWN;
+      t[0x51] = KEY_PAGE_DOWN;
+      t[0x52] = KEY_INSERT;
+      t[0x53] = KEY_DELETE;
+
+      return t;
+    }
+
+    static constexpr extended_table extended_scancodes = make_extended_table();
+
+    /* Currently held modifiers, in enum order (LSHIFT...RALT) */
+    static bool held[KEY_RALT - KEY_LSHIFT + 1];
+
+    /* Set after a 0xE0 prefix byte */
+    static bool extended;
+
+    /* Scancodes waiting for the bottom half */
+    static apex::spsc_ring<uint8_t, 32> scancodes_pending;
+
+    /** Event handling (bottom half) -- translates scancodes and runs callbacks */
+    static void process_scancodes(void*)
     {
-      event_t e;
+      uint8_t code;
+      while(scancodes_pending.pop(code))
+      {
+        /* Extended keys arrive as two bytes */
+        if(code == 0xE0)
+        {
+          extended = true;
+          continue;
+        }
+
+        event_t e;
+        e.type = (code & 0x80) ? event_t::RELEASED : event_t::PRESSED;
+        e.key = scancodes[code & 0x7f].key;
+
+        /* Extended keys have their own table, and never have ascii */
+        bool was_extended = extended;
+        if(extended)
+        {
+          e.key = extended_scancodes[code & 0x7f];
+          extended = false;
+        }
+
+        if(e.key >= KEY_LSHIFT && e.key <= KEY_RALT)
+          held[e.key - KEY_LSHIFT] = e.type == event_t::PRESSED;
 
-      ports::in_8(0x60);
-      pic::acknowledge(pic::irq_t::KEYBOARD);
+        bool shift = held[KEY_LSHIFT - KEY_LSHIFT] || held[KEY_RSHIFT - KEY_LSHIFT];
+        e.ascii = shift ? scancodes[code & 0x7f].shifted : scancodes[code & 0x7f].ascii;
+        if(e.key == KEY_NULL || was_extended)
+          e.ascii = 0;
 
-      for(event_callback f : callbacks)
-        f(e);
+        std::size_t m = 0;
+        for(int k = KEY_LSHIFT; k <= KEY_RALT; ++k)
+          if(held[k - KEY_LSHIFT])
+            e.modifiers[m++] = key_t(k);
+
+        dispatching = true;
+        if(auto const* handlers = callbacks.read())
+          for(auto const& h : *handlers)
+            h.handler(e);
+        dispatching = false;
+      }
+
+      /* Callbacks may have (de)registered callbacks */
+      callbacks.reclaim();
+    }
+
+    /** Interrupt handling (top half) -- only reads and queues the scancode */
+    void int_handler(interrupts::interrupt_frame&)
+    {
+      scancodes_pending.push(ports::in_8(0x60));
+
+      softirq::raise(&process_scancodes);
     }
 
     /** Keyboard setup */
     void enable()
     {
-      /* Register keyboard ISR */
-      interrupts::add(0x21, &int_handler, true);
-      pic::unmask(pic::irq_t::KEYBOARD);
+      /* Register keyboard ISR (IRQ1) */
+      irq::install(1, &int_handler);
     }
 
     /** Keyboard cleanup */
     void disable()
     {
       /* Cleanup keyboard ISR */
-      pic::mask(pic::irq_t::KEYBOARD);
-      interrupts::remove(0x21);
+      irq::uninstall(1, &int_handler);
     }
 
     /** Add a callback */
-    void register_callback(event_callback f)
+    void register_callback(event_callback f, int priority)
     {
-      callbacks.push_back(f);
+      if(!callbacks.add(f, priority))
+        apex::__break();
+
+      if(!dispatching)
+        callbacks.reclaim();
     }
 
     /** Remove a callback */
     void deregister_callback(event_callback f)
     {
-      for(std::vector<event_callback>::iterator it = callbacks.begin();
-          it != callbacks.end();
-          )
-      {
-        if(*it == f)
-          it = callbacks.erase(it);
-        else
-          ++it;
-      }
+      callbacks.remove(f);
+
+      if(!dispatching)
+        callbacks.reclaim();
     }
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,167 @@
+#include "klog"
+
+/* Kernel */
+#include "idle"
+
+/* IO */
+#include <serial>
+
+/* APEX */
+#include <clock>
+#include <helpers>
+#include <mpsc_ring>
+
+/* STL */
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+/* Filled by anyone, drained by drain() */
+static apex::mpsc_ring<klog::entry, klog::queue_size> queue;
+
+/* The last dmesg_size messages (dmesg_head is the next to overwrite) */
+static std::array<klog::entry, klog::dmesg_size> dmesg_entries;
+static uint32_t dmesg_head;
+static uint32_t dmesg_count;
+
+/* Sinks */
+static std::array<klog::sink_func, klog::max_sinks> sinks;
+static unsigned int sink_count;
+
+/* The screen written by screen_sink */
+static io::screen::vga_screen* log_screen;
+
+/* Accounting */
+static volatile uint32_t logged;
+static volatile uint32_t dropped;
+
+/* Per level -- the color (SGR), and the letter */
+static constexpr std::array<std::string_view, 4> level_colors = {"\x1b[90m", "\x1b[0m", "\x1b[93m", "\x1b[91m"};
+static constexpr std::array<char, 4> level_letters = {'D', 'I', 'W', 'E'};
+
+/* Queue from anywhere */
+bool klog::submit(level lvl, std::string_view message)
+{
+  entry e;
+  e.timestamp_ns = apex::clock::now();
+  e.lvl = lvl;
+  e.length = std::min<std::size_t>(message.size(), max_message);
+  std::memcpy(e.text, message.data(), e.length);
+
+  if(!queue.push(e))
+  {
+    __atomic_add_fetch(&dropped, 1, __ATOMIC_RELAXED);
+    return false;
+  }
+
+  __atomic_add_fetch(&logged, 1, __ATOMIC_RELAXED);
+  idle::wake();
+  return true;
+}
+
+/* Sink registration */
+void klog::add_sink(sink_func f)
+{
+  if(sink_count >= sinks.size())
+    apex::__break();
+
+  sinks[sink_count++] = f;
+}
+
+/* Writes to the attached screen */
+static void screen_sink(klog::entry const& e)
+{
+  char line[klog::max_line];
+  log_screen->write(klog::format(e, line));
+}
+
+/* Writes to COM1 */
+static void serial_sink(klog::entry const& e)
+{
+  char line[klog::max_line];
+  io::serial::write(klog::format(e, line));
+}
+
+/* Screen sink setup */
+void klog::attach_screen(io::screen::vga_screen& screen)
+{
+  if(!log_screen)
+    add_sink(&screen_sink);
+
+  log_screen = &screen;
+}
+
+/* Serial sink setup */
+void klog::attach_serial()
+{
+  add_sink(&serial_sink);
+}
+
+/* Drain */
+void klog::drain()
+{
+  entry e;
+  while(queue.pop(e))
+  {
+    dmesg_entries[dmesg_head] = e;
+    dmesg_head = (dmesg_head + 1) % dmesg_size;
+    if(dmesg_count < dmesg_size)
+      ++dmesg_count;
+
+    for(unsigned int i = 0; i < sink_count; ++i)
+      sinks[i](e);
+  }
+}
+
+/* Replay */
+void klog::dmesg(sink_func f)
+{
+  uint32_t first = (dmesg_head + dmesg_size - dmesg_count) % dmesg_size;
+  for(uint32_t i = 0; i < dmesg_count; ++i)
+    f(dmesg_entries[(first + i) % dmesg_size]);
+}
+
+/* Writes value as exactly digits decimal digits, padding with pad */
+static char* put_number(char* out, uint32_t value, unsigned int digits, char pad)
+{
+  for(unsigned int i = digits; i-- > 0; value /= 10)
+    out[i] = (value || i == digits - 1) ? '0' + value % 10 : pad;
+
+  return out + digits;
+}
+
+/* Formatting */
+std::string_view klog::format(entry const& e, char* buffer)
+{
+  char* out = buffer;
+  unsigned int lvl = static_cast<unsigned int>(e.lvl);
+
+  std::string_view color = level_colors[lvl];
+  out = std::copy(color.begin(), color.end(), out);
+
+  uint64_t micros = e.timestamp_ns / 1000;
+  *out++ = '[';
+  out = put_number(out, static_cast<uint32_t>(micros / 1000000), 5, ' ');
+  *out++ = '.';
+  out = put_number(out, static_cast<uint32_t>(micros % 1000000), 6, '0');
+  *out++ = ']';
+  *out++ = ' ';
+  *out++ = level_letters[lvl];
+  *out++ = ' ';
+
+  out = std::copy(e.text, e.text + e.length, out);
+
+  std::string_view reset = "\x1b[0m\n";
+  out = std::copy(reset.begin(), reset.end(), out);
+
+  return std::string_view(buffer, out - buffer);
+}
+
+/* Accounting */
+klog::stats_t klog::stats()
+{
+  stats_t s;
+  s.logged = logged;
+  s.dropped = dropped;
+  return s;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+/* IO */
+#include <vga_screen>
+
+/* APEX */
+#include <stack_string>
+
+/* STL */
+#include <string_view>
+
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * The kernel log
+ *
+ * Logging only copies the message into a lock-free ring, so it's safe (and cheap)
+ *   from any context, including interrupt handlers.
+ * drain() (run from the idle loop) hands each message to the sinks,
+ *   which do the slow part -- drawing to VRAM, or waiting on a UART.
+ *
+ * Every message is also kept in dmesg, the last dmesg_size messages.
+ * Messages below min_level are compiled out.
+ */
+namespace klog
+{
+  /**
+   * @enum level
+   * @brief The severity of a message
+   */
+  enum class level : uint8_t
+  {
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+  };
+
+  /* The least severe level that is logged (DEBUG only in debug builds) */
+#ifdef _DEBUG
+  constexpr level min_level = level::DEBUG;
+#else
+  constexpr level min_level = level::INFO;
+#endif
+
+  /* The longest message kept, longer ones are truncated */
+  constexpr unsigned int max_message = 110;
+
+  /* The number of messages that can be waiting for drain() */
+  constexpr uint32_t queue_size = 64;
+
+  /* The number of messages kept in dmesg */
+  constexpr uint32_t dmesg_size = 128;
+
+  /* The maximum number of sinks */
+  constexpr unsigned int max_sinks = 4;
+
+  /**
+   * @struct entry
+   * @brief A single logged message
+   */
+  struct entry
+  {
+    /** @brief When the message was logged, in ns (see apex::clock::now) */
+    uint64_t timestamp_ns;
+    /** @brief The severity */
+    level lvl;
+    /** @brief The length of text */
+    uint8_t length;
+    /** @brief The message (not null-terminated) */
+    char text[max_message];
+
+    std::string_view message() const
+      { return std::string_view(text, length); }
+  };
+
+  /** Signature for a sink, run from drain() */
+  using sink_func = void(*)(entry const&);
+
+  /**
+   * Queues a message for the sinks, and wakes the idle loop
+   * Safe to call from any context, even before static constructors have run
+   *
+   * @return False if the queue was full (the message is dropped and counted)
+   */
+  bool submit(level lvl, std::string_view message);
+
+  /**
+   * Logs a message, if lvl is at least min_level
+   */
+  template<level lvl>
+  inline void write(std::string_view message)
+  {
+    if constexpr(lvl >= min_level)
+      submit(lvl, message);
+  }
+
+  template<level lvl>
+  inline void write(char const* message)
+    { write<lvl>(std::string_view(message)); }
+
+  template<level lvl>
+  inline void write(apex::stack_string const& message)
+    { write<lvl>(std::string_view(message.c_str(), message.size())); }
+
+  /**
+   * Logs a message at a fixed level
+   */
+  template<typename String>
+  inline void debug(String const& message)
+    { write<level::DEBUG>(message); }
+
+  template<typename String>
+  inline void info(String const& message)
+    { write<level::INFO>(message); }
+
+  template<typename String>
+  inline void warn(String const& message)
+    { write<level::WARN>(message); }
+
+  template<typename String>
+  inline void error(String const& message)
+    { write<level::ERROR>(message); }
+
+  /**
+   * Registers a sink, which receives every message drained after this
+   */
+  void add_sink(sink_func f);
+
+  /**
+   * Writes messages to a screen (a sink for each screen isn't supported, only the last one attached is used)
+   */
+  void attach_screen(io::screen::vga_screen& screen);
+
+  /**
+   * Writes messages to COM1 (see io::serial)
+   */
+  void attach_serial();
+
+  /**
+   * Hands every queued message to the sinks
+   * (registered with the idle loop by the kernel)
+   */
+  void drain();
+
+  /**
+   * Replays the messages kept in dmesg (oldest first) through a sink
+   */
+  void dmesg(sink_func f);
+
+  /* The longest formatted message */
+  constexpr unsigned int max_line = max_message + 32;
+
+  /**
+   * Formats a message as "[seconds.micros] L message\n", coloured with VT100 escapes
+   *
+   * @param e       The message
+   * @param buffer  At least max_line characters
+   * @return The formatted message, in buffer
+   */
+  std::string_view format(entry const& e, char* buffer);
+
+  /**
+   * @struct stats_t
+   * @brief Log accounting
+   */
+  struct stats_t
+  {
+    /** @brief Messages queued */
+    uint32_t logged;
+    /** @brief Messages dropped because the queue was full */
+    uint32_t dropped;
+  };
+
+  /**
+   * @return The current log accounting
+   */
+  stats_t stats();
+}
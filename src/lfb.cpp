@@ -0,0 +1,176 @@
+#include "lfb"
+
+/* Kernel */
+#include "page_manager"
+
+/* IO */
+#include <font>
+
+/* STL */
+#include <cstring>
+#include <vector>
+
+#define GLYPH_CACHE_SLOTS   256
+
+namespace lfb
+{
+  using io::screen::cell_t;
+  using io::screen::coord;
+
+  /* The framebuffer, copied out of the tag (the tags aren't mapped once paging is enabled) */
+  static uint64_t fb_addr;
+  static uint32_t fb_pitch;
+  static uint32_t fb_width;
+  static uint32_t fb_height;
+  static uint8_t fb_bpp;
+  static multiboot2::tag_framebuffer::framebuffer_type fb_type;
+  static multiboot2::tag_framebuffer::rgb_info fb_rgb;
+
+  /* The mapped framebuffer */
+  static uint8_t* pixels;
+
+  /* The BIOS colors, converted to the framebuffer's pixel format */
+  static uint32_t palette[16];
+
+  /* The cells drawn into, and the cells currently on the framebuffer */
+  static std::vector<cell_t> cells;
+  static std::vector<cell_t> shown;
+
+  /* The cursor, drawn as an underline over its cell */
+  static bool cursor_shown;
+  static coord cursor{0,0};
+
+  /* A direct-mapped cache of rendered cells (most screens only use a few cell values) */
+  struct glyph_slot
+  {
+    /* The cell rendered, plus one (0 marks an empty slot) */
+    uint32_t key;
+    uint32_t pixels[io::font::height][io::font::width];
+  };
+  static glyph_slot glyph_cache[GLYPH_CACHE_SLOTS];
+
+  static io::screen::cell_display display{{0,0}, nullptr, nullptr, nullptr};
+
+  /** Framebuffer tag */
+  void set_framebuffer(const multiboot2::tag_framebuffer* tag)
+  {
+    fb_addr = tag->addr;
+    fb_pitch = tag->pitch;
+    fb_width = tag->width;
+    fb_height = tag->height;
+    fb_bpp = tag->bpp;
+    fb_type = tag->type;
+    if(fb_type == multiboot2::tag_framebuffer::RGB)
+      fb_rgb = *tag->rgb();
+  }
+
+  /* Scales an 8-bit component into its place in a pixel */
+  static uint32_t component(uint8_t value, uint8_t position, uint8_t size)
+  {
+    if(size >= 8)
+      return static_cast<uint32_t>(value) << (position + size - 8);
+    return static_cast<uint32_t>(value >> (8 - size)) << position;
+  }
+
+  /* Converts a 0xRRGGBB color to the pixel format */
+  static uint32_t make_pixel(uint32_t rgb)
+  {
+    return component(rgb >> 16, fb_rgb.red_position, fb_rgb.red_size)
+         | component(rgb >> 8, fb_rgb.green_position, fb_rgb.green_size)
+         | component(rgb, fb_rgb.blue_position, fb_rgb.blue_size);
+  }
+
+  /* Renders a cell (through the cache) */
+  static const glyph_slot& render(cell_t cell)
+  {
+    glyph_slot& slot = glyph_cache[(cell ^ (cell >> 8)) % GLYPH_CACHE_SLOTS];
+    if(slot.key == cell + 1u)
+      return slot;
+
+    uint32_t fg = palette[(cell >> 8) & 0x0f];
+    uint32_t bg = palette[(cell >> 12) & 0x0f];
+    const uint8_t* glyph = io::font::glyphs[cell & 0xff];
+    for(unsigned int y = 0; y < io::font::height; ++y)
+      for(unsigned int x = 0; x < io::font::width; ++x)
+        slot.pixels[y][x] = (glyph[y] & (0x80 >> x)) ? fg : bg;
+
+    slot.key = cell + 1u;
+    return slot;
+  }
+
+  /* Draws a single cell, with the cursor if it's there */
+  static void draw(unsigned short x, unsigned short y)
+  {
+    cell_t cell = cells[y * display.size.x + x];
+    const glyph_slot& slot = render(cell);
+
+    uint8_t* dst = pixels + y * io::font::height * fb_pitch + x * io::font::width * sizeof(uint32_t);
+    for(unsigned int row = 0; row < io::font::height; ++row, dst += fb_pitch)
+      std::memcpy(dst, slot.pixels[row], sizeof(slot.pixels[row]));
+
+    if(cursor_shown && cursor.x == x && cursor.y == y)
+    {
+      uint32_t* line = reinterpret_cast<uint32_t*>(dst - fb_pitch);
+      for(unsigned int i = 0; i < io::font::width; ++i)
+        line[i] = palette[(cell >> 8) & 0x0f];
+    }
+
+    shown[y * display.size.x + x] = cell;
+  }
+
+  /* Draws the changed cells of a row span */
+  static void flush(unsigned short y, unsigned short first, unsigned short last)
+  {
+    std::size_t row = y * display.size.x;
+    for(unsigned short x = first; x < last; ++x)
+      if(cells[row + x] != shown[row + x])
+        draw(x, y);
+  }
+
+  /* Moves the cursor, redrawing the cells it leaves and enters */
+  static void set_cursor(bool is_shown, coord const& abs)
+  {
+    bool was_shown = cursor_shown;
+    coord old = cursor;
+
+    cursor_shown = is_shown;
+    cursor = abs;
+
+    if(was_shown)
+      draw(old.x, old.y);
+    if(is_shown)
+      draw(abs.x, abs.y);
+  }
+
+  /** Console setup */
+  const io::screen::cell_display* console()
+  {
+    if(fb_type != multiboot2::tag_framebuffer::RGB || fb_bpp != 32 || fb_addr >> 32)
+      return nullptr;
+
+    uint32_t length = fb_pitch * fb_height;
+    pixels = static_cast<uint8_t*>(page_manager::get_current_manager()->map_write_combining(fb_addr, length));
+
+    constexpr uint32_t colors[16] =
+    {
+      0x000000, 0x0000aa, 0x00aa00, 0x00aaaa, 0xaa0000, 0xaa00aa, 0xaa5500, 0xaaaaaa,
+      0x555555, 0x5555ff, 0x55ff55, 0x55ffff, 0xff5555, 0xff55ff, 0xffff55, 0xffffff,
+    };
+    for(unsigned int i = 0; i < 16; ++i)
+      palette[i] = make_pixel(colors[i]);
+
+    display.size = {static_cast<unsigned short>(fb_width / io::font::width),
+                    static_cast<unsigned short>(fb_height / io::font::height)};
+
+    /* Everything starts black, a cell that will never be drawn marks them all stale */
+    std::size_t count = display.size.x * display.size.y;
+    cells.resize(count, 0);
+    shown.resize(count, 0xffff);
+    std::memset(pixels, 0, length);
+
+    display.cells = cells.data();
+    display.flush = &flush;
+    display.set_cursor = &set_cursor;
+    return &display;
+  }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+/* Kernel */
+#include "multiboot2"
+
+/* IO */
+#include <vga_screen>
+
+/**
+ * A text console drawn on the linear framebuffer the bootloader set up
+ *
+ * Cells are rendered with the built-in 8x8 font, so a 1024x768 framebuffer
+ * shows 128x96 cells. Only 32bpp RGB framebuffers below 4GiB are supported.
+ */
+namespace lfb
+{
+  /**
+   * @brief Remembers the framebuffer tag (called while parsing multiboot tags)
+   */
+  extern void set_framebuffer(const multiboot2::tag_framebuffer* tag);
+
+  /**
+   * @brief Maps the framebuffer (write-combining) and sets up the console
+   *
+   * @return The console's display, or nullptr if there is no usable framebuffer
+   */
+  extern const io::screen::cell_display* console();
+}
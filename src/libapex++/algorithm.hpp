@@ -1,7 +1,21 @@
 #pragma once
 
 /* STL */
+#include "cstddef"
+#include "cstring"
 #include "libstl"
+#include "type_traits"
+#include "utility_forward"
+
+/**
+ * The definition of the well-documented <algorithm> file
+ *
+ * Every algorithm is iterator-based (raw pointers included), so an
+ *   execution-policy overload can later be layered on top of each one.
+ * Ranges of trivial types over raw pointers are routed to memmove/memset/memcmp.
+ *
+ * http://en.cppreference.com/w/cpp/header/algorithm
+ */
 
 STL_BEGIN
 
@@ -9,27 +23,27 @@ STL_BEGIN
 namespace lexi
 {
   template<typename T1, typename T2>
-  bool equal(T1 const& lhs, T2 const& rhs)
+  constexpr bool equal(T1 const& lhs, T2 const& rhs)
   { return !(lhs < rhs || rhs < lhs); }
 
   template<typename T1, typename T2>
-  bool not_equal(T1 const& lhs, T2 const& rhs)
+  constexpr bool not_equal(T1 const& lhs, T2 const& rhs)
   { return !equal(lhs, rhs); }
 
   template<typename T1, typename T2>
-  bool less_than(T1 const& lhs, T2 const& rhs)
+  constexpr bool less_than(T1 const& lhs, T2 const& rhs)
   { return lhs < rhs; }
 
   template<typename T1, typename T2>
-  bool less_or_equal(T1 const& lhs, T2 const& rhs)
+  constexpr bool less_or_equal(T1 const& lhs, T2 const& rhs)
   { return less_than(lhs,rhs) || equal(lhs,rhs); }
 
   template<typename T1, typename T2>
-  bool greater_than(T1 const& lhs, T2 const& rhs)
+  constexpr bool greater_than(T1 const& lhs, T2 const& rhs)
   { return !less_than(lhs,rhs) && !equal(lhs,rhs); }
 
   template<typename T1, typename T2>
-  bool greater_or_equal(T1 const& lhs, T2 const& rhs)
+  constexpr bool greater_or_equal(T1 const& lhs, T2 const& rhs)
   { return !less_than(lhs,rhs); }
 }
 
@@ -50,4 +64,598 @@ template<typename T>
 const T& max(const T& lhs, const T& rhs, auto comp)
 { return (!comp(lhs, rhs)) ? lhs : rhs; }
 
+namespace detail
+{
+  /* The element type an iterator refers to */
+  template<typename It>
+  using iter_value_t = typename remove_cv<typename remove_reference<decltype(*declval<It&>())>::type>::type;
+
+  /* The default comparison, only using < */
+  struct less
+  {
+    template<typename T1, typename T2>
+    constexpr bool operator()(T1 const& lhs, T2 const& rhs) const
+    { return lhs < rhs; }
+  };
+
+  /* True if copying [In, In+n) to Out can be done with memmove */
+  template<typename In, typename Out>
+  struct is_memmovable : public false_type
+  { };
+
+  template<typename T, typename U>
+  struct is_memmovable<T*, U*>
+  : public bool_constant<is_same<typename remove_cv<T>::type, U>::value &&
+                         is_trivially_copyable<U>::value>
+  { };
+
+  /* True if comparing [L, L+n) to [R, R+n) for equality can be done with memcmp */
+  template<typename L, typename R>
+  struct is_memcmpable_equal : public false_type
+  { };
+
+  template<typename T, typename U>
+  struct is_memcmpable_equal<T*, U*>
+  : public bool_constant<is_same<typename remove_cv<T>::type, typename remove_cv<U>::type>::value &&
+                         (is_integral<typename remove_cv<T>::type>::value ||
+                          is_pointer<typename remove_cv<T>::type>::value)>
+  { };
+
+  /* True if ordering [L, L+n) against [R, R+n) can be done with memcmp (unsigned bytes only) */
+  template<typename L, typename R>
+  struct is_memcmpable_less : public false_type
+  { };
+
+  template<typename T, typename U>
+  struct is_memcmpable_less<T*, U*>
+  : public bool_constant<is_same<typename remove_cv<T>::type, unsigned char>::value &&
+                         is_same<typename remove_cv<U>::type, unsigned char>::value>
+  { };
+
+  /* True if filling [It, It+n) with a value can be done with memset */
+  template<typename It, typename T>
+  struct is_memsettable : public false_type
+  { };
+
+  template<typename T, typename U>
+  struct is_memsettable<T*, U>
+  : public bool_constant<sizeof(T) == 1 && is_integral<T>::value && is_integral<U>::value>
+  { };
+}
+
+/**
+ * Swaps the values two iterators refer to
+ */
+template<typename It1, typename It2>
+void iter_swap(It1 a, It2 b)
+{
+  auto temp = std::move(*a);
+  *a = std::move(*b);
+  *b = std::move(temp);
+}
+
+/**
+ * Non-modifying sequence operations
+ */
+
+/* First element equal to value, or last */
+template<typename InputIt, typename T>
+constexpr InputIt find(InputIt first, InputIt last, T const& value)
+{
+  for(; first != last; ++first)
+    if(*first == value)
+      return first;
+
+  return last;
+}
+
+/* First element satisfying pred, or last */
+template<typename InputIt, typename Pred>
+constexpr InputIt find_if(InputIt first, InputIt last, Pred pred)
+{
+  for(; first != last; ++first)
+    if(pred(*first))
+      return first;
+
+  return last;
+}
+
+/* First element not satisfying pred, or last */
+template<typename InputIt, typename Pred>
+constexpr InputIt find_if_not(InputIt first, InputIt last, Pred pred)
+{
+  for(; first != last; ++first)
+    if(!pred(*first))
+      return first;
+
+  return last;
+}
+
+/* True if [first1, last1) equals the range starting at first2 */
+template<typename InputIt1, typename InputIt2, typename Pred>
+constexpr bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2, Pred pred)
+{
+  for(; first1 != last1; ++first1, ++first2)
+    if(!pred(*first1, *first2))
+      return false;
+
+  return true;
+}
+
+namespace detail
+{
+  template<typename InputIt1, typename InputIt2>
+  bool equal_impl(InputIt1 first1, InputIt1 last1, InputIt2 first2, false_type)
+  {
+    for(; first1 != last1; ++first1, ++first2)
+      if(!(*first1 == *first2))
+        return false;
+
+    return true;
+  }
+
+  template<typename T, typename U>
+  bool equal_impl(T* first1, T* last1, U* first2, true_type)
+  { return std::memcmp(first1, first2, (last1 - first1) * sizeof(T)) == 0; }
+}
+
+template<typename InputIt1, typename InputIt2>
+bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2)
+{ return detail::equal_impl(first1, last1, first2, detail::is_memcmpable_equal<InputIt1, InputIt2>()); }
+
+/* True if [first1, last1) orders before [first2, last2) */
+template<typename InputIt1, typename InputIt2, typename Compare>
+constexpr bool lexicographical_compare(InputIt1 first1, InputIt1 last1,
+                                       InputIt2 first2, InputIt2 last2,
+                                       Compare comp)
+{
+  for(; first1 != last1 && first2 != last2; ++first1, ++first2)
+  {
+    if(comp(*first1, *first2))
+      return true;
+    if(comp(*first2, *first1))
+      return false;
+  }
+
+  return first1 == last1 && first2 != last2;
+}
+
+namespace detail
+{
+  template<typename InputIt1, typename InputIt2>
+  bool lexicographical_compare_impl(InputIt1 first1, InputIt1 last1,
+                                    InputIt2 first2, InputIt2 last2,
+                                    false_type)
+  { return std::lexicographical_compare(first1, last1, first2, last2, detail::less()); }
+
+  template<typename T, typename U>
+  bool lexicographical_compare_impl(T* first1, T* last1,
+                                    U* first2, U* last2,
+                                    true_type)
+  {
+    std::size_t len1 = last1 - first1;
+    std::size_t len2 = last2 - first2;
+    int result = std::memcmp(first1, first2, len1 < len2 ? len1 : len2);
+    return result ? result < 0 : len1 < len2;
+  }
+}
+
+template<typename InputIt1, typename InputIt2>
+bool lexicographical_compare(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2)
+{
+  return detail::lexicographical_compare_impl(first1, last1, first2, last2,
+                                              detail::is_memcmpable_less<InputIt1, InputIt2>());
+}
+
+/**
+ * Modifying sequence operations
+ */
+
+namespace detail
+{
+  template<typename InputIt, typename OutputIt>
+  OutputIt copy_impl(InputIt first, InputIt last, OutputIt d_first, false_type)
+  {
+    for(; first != last; ++first, ++d_first)
+      *d_first = *first;
+
+    return d_first;
+  }
+
+  template<typename T, typename U>
+  U* copy_impl(T* first, T* last, U* d_first, true_type)
+  {
+    std::size_t count = last - first;
+    std::memmove(d_first, first, count * sizeof(U));
+    return d_first + count;
+  }
+
+  template<typename BidirIt1, typename BidirIt2>
+  BidirIt2 copy_backward_impl(BidirIt1 first, BidirIt1 last, BidirIt2 d_last, false_type)
+  {
+    while(first != last)
+      *(--d_last) = *(--last);
+
+    return d_last;
+  }
+
+  template<typename T, typename U>
+  U* copy_backward_impl(T* first, T* last, U* d_last, true_type)
+  {
+    std::size_t count = last - first;
+    std::memmove(d_last - count, first, count * sizeof(U));
+    return d_last - count;
+  }
+
+  template<typename InputIt, typename OutputIt>
+  OutputIt move_impl(InputIt first, InputIt last, OutputIt d_first, false_type)
+  {
+    for(; first != last; ++first, ++d_first)
+      *d_first = std::move(*first);
+
+    return d_first;
+  }
+
+  template<typename T, typename U>
+  U* move_impl(T* first, T* last, U* d_first, true_type)
+  { return copy_impl(first, last, d_first, true_type()); }
+
+  template<typename OutputIt, typename T>
+  void fill_impl(OutputIt first, OutputIt last, T const& value, false_type)
+  {
+    for(; first != last; ++first)
+      *first = value;
+  }
+
+  template<typename U, typename T>
+  void fill_impl(U* first, U* last, T const& value, true_type)
+  { std::memset(first, static_cast<unsigned char>(value), last - first); }
+}
+
+/* Copies [first, last) to d_first, returns the end of the destination */
+template<typename InputIt, typename OutputIt>
+OutputIt copy(InputIt first, InputIt last, OutputIt d_first)
+{ return detail::copy_impl(first, last, d_first, detail::is_memmovable<InputIt, OutputIt>()); }
+
+/* Copies the first count elements of first to d_first */
+template<typename InputIt, typename Size, typename OutputIt>
+OutputIt copy_n(InputIt first, Size count, OutputIt d_first)
+{ return std::copy(first, first + count, d_first); }
+
+/* Copies [first, last) to end at d_last, returns the start of the destination */
+template<typename BidirIt1, typename BidirIt2>
+BidirIt2 copy_backward(BidirIt1 first, BidirIt1 last, BidirIt2 d_last)
+{ return detail::copy_backward_impl(first, last, d_last, detail::is_memmovable<BidirIt1, BidirIt2>()); }
+
+/* Moves [first, last) to d_first, returns the end of the destination */
+template<typename InputIt, typename OutputIt>
+OutputIt move(InputIt first, InputIt last, OutputIt d_first)
+{ return detail::move_impl(first, last, d_first, detail::is_memmovable<InputIt, OutputIt>()); }
+
+/* Assigns value to every element in [first, last) */
+template<typename OutputIt, typename T>
+void fill(OutputIt first, OutputIt last, T const& value)
+{ detail::fill_impl(first, last, value, detail::is_memsettable<OutputIt, T>()); }
+
+/* Assigns value to count elements starting at first */
+template<typename OutputIt, typename Size, typename T>
+OutputIt fill_n(OutputIt first, Size count, T const& value)
+{
+  std::fill(first, first + count, value);
+  return first + count;
+}
+
+/* Reverses [first, last) */
+template<typename BidirIt>
+void reverse(BidirIt first, BidirIt last)
+{
+  while(first != last && first != --last)
+    std::iter_swap(first++, last);
+}
+
+/*
+ * Rotates [first, last) so middle becomes first, returns where first ended up
+ * Requires random-access iterators (the result is computed with iterator arithmetic)
+ */
+template<typename RandomIt>
+RandomIt rotate(RandomIt first, RandomIt middle, RandomIt last)
+{
+  if(first == middle)
+    return last;
+  if(middle == last)
+    return first;
+
+  RandomIt result = first + (last - middle);
+  std::reverse(first, middle);
+  std::reverse(middle, last);
+  std::reverse(first, last);
+  return result;
+}
+
+/**
+ * Binary search operations (on sorted ranges)
+ */
+
+/* First element not less than value */
+template<typename ForwardIt, typename T, typename Compare>
+constexpr ForwardIt lower_bound(ForwardIt first, ForwardIt last, T const& value, Compare comp)
+{
+  auto count = last - first;
+  while(count > 0)
+  {
+    auto step = count / 2;
+    ForwardIt it = first + step;
+    if(comp(*it, value))
+    {
+      first = ++it;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+
+  return first;
+}
+
+template<typename ForwardIt, typename T>
+constexpr ForwardIt lower_bound(ForwardIt first, ForwardIt last, T const& value)
+{ return std::lower_bound(first, last, value, detail::less()); }
+
+/* First element greater than value */
+template<typename ForwardIt, typename T, typename Compare>
+constexpr ForwardIt upper_bound(ForwardIt first, ForwardIt last, T const& value, Compare comp)
+{
+  auto count = last - first;
+  while(count > 0)
+  {
+    auto step = count / 2;
+    ForwardIt it = first + step;
+    if(!comp(value, *it))
+    {
+      first = ++it;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+
+  return first;
+}
+
+template<typename ForwardIt, typename T>
+constexpr ForwardIt upper_bound(ForwardIt first, ForwardIt last, T const& value)
+{ return std::upper_bound(first, last, value, detail::less()); }
+
+/* True if an element equivalent to value is present */
+template<typename ForwardIt, typename T, typename Compare>
+constexpr bool binary_search(ForwardIt first, ForwardIt last, T const& value, Compare comp)
+{
+  first = std::lower_bound(first, last, value, comp);
+  return first != last && !comp(value, *first);
+}
+
+template<typename ForwardIt, typename T>
+constexpr bool binary_search(ForwardIt first, ForwardIt last, T const& value)
+{ return std::binary_search(first, last, value, detail::less()); }
+
+/**
+ * Sorting operations (random-access iterators)
+ */
+
+namespace detail
+{
+  /* Ranges at or below this size are finished with insertion sort */
+  constexpr std::ptrdiff_t sort_threshold = 16;
+
+  /* Stable insertion sort, for small ranges */
+  template<typename RandomIt, typename Compare>
+  void insertion_sort(RandomIt first, RandomIt last, Compare comp)
+  {
+    if(first == last)
+      return;
+
+    for(RandomIt i = first + 1; i != last; ++i)
+    {
+      iter_value_t<RandomIt> val = std::move(*i);
+      RandomIt j = i;
+      for(; j != first && comp(val, *(j - 1)); --j)
+        *j = std::move(*(j - 1));
+      *j = std::move(val);
+    }
+  }
+
+  /* Sifts the element at hole down a max-heap of len elements */
+  template<typename RandomIt, typename Compare>
+  void sift_down(RandomIt first, std::ptrdiff_t hole, std::ptrdiff_t len, Compare comp)
+  {
+    iter_value_t<RandomIt> val = std::move(*(first + hole));
+    for(std::ptrdiff_t child = 2 * hole + 1; child < len; child = 2 * hole + 1)
+    {
+      if(child + 1 < len && comp(*(first + child), *(first + child + 1)))
+        ++child;
+
+      if(!comp(val, *(first + child)))
+        break;
+
+      *(first + hole) = std::move(*(first + child));
+      hole = child;
+    }
+    *(first + hole) = std::move(val);
+  }
+
+  /* Heapsort -- introsort's fallback, guaranteeing O(n log n) */
+  template<typename RandomIt, typename Compare>
+  void heap_sort(RandomIt first, RandomIt last, Compare comp)
+  {
+    std::ptrdiff_t len = last - first;
+    for(std::ptrdiff_t i = len / 2; i-- > 0;)
+      sift_down(first, i, len, comp);
+
+    for(std::ptrdiff_t end = len - 1; end > 0; --end)
+    {
+      std::iter_swap(first, first + end);
+      sift_down(first, 0, end, comp);
+    }
+  }
+
+  /* Moves the median of a, b, c into a */
+  template<typename RandomIt, typename Compare>
+  void median_to_first(RandomIt a, RandomIt b, RandomIt c, Compare comp)
+  {
+    if(comp(*b, *a))
+      std::iter_swap(a, b);
+    if(comp(*c, *b))
+    {
+      std::iter_swap(b, c);
+      if(comp(*b, *a))
+        std::iter_swap(a, b);
+    }
+    std::iter_swap(a, b);
+  }
+
+  /* Partitions around *first (Hoare), returns the start of the right half */
+  template<typename RandomIt, typename Compare>
+  RandomIt partition_pivot(RandomIt first, RandomIt last, Compare comp)
+  {
+    median_to_first(first, first + (last - first) / 2, last - 1, comp);
+
+    RandomIt left = first + 1;
+    RandomIt right = last;
+    for(;;)
+    {
+      while(comp(*left, *first))
+        ++left;
+      --right;
+      while(comp(*first, *right))
+        --right;
+
+      if(!(left < right))
+        return left;
+
+      std::iter_swap(left, right);
+      ++left;
+    }
+  }
+
+  /* Quicksort until depth_limit is exhausted, then heapsort */
+  template<typename RandomIt, typename Compare>
+  void introsort_loop(RandomIt first, RandomIt last, unsigned depth_limit, Compare comp)
+  {
+    while(last - first > sort_threshold)
+    {
+      if(!depth_limit--)
+      {
+        heap_sort(first, last, comp);
+        return;
+      }
+
+      RandomIt cut = partition_pivot(first, last, comp);
+
+      /* Recurse on the smaller half to bound the stack depth */
+      if(cut - first < last - cut)
+      {
+        introsort_loop(first, cut, depth_limit, comp);
+        first = cut;
+      }
+      else
+      {
+        introsort_loop(cut, last, depth_limit, comp);
+        last = cut;
+      }
+    }
+  }
+
+  /* Merges the sorted [first, middle) and [middle, last) in place (no allocation) */
+  template<typename RandomIt, typename Compare>
+  void merge_in_place(RandomIt first, RandomIt middle, RandomIt last, Compare comp)
+  {
+    std::ptrdiff_t len1 = middle - first;
+    std::ptrdiff_t len2 = last - middle;
+    if(!len1 || !len2)
+      return;
+
+    if(len1 + len2 == 2)
+    {
+      if(comp(*middle, *first))
+        std::iter_swap(first, middle);
+      return;
+    }
+
+    /* Split the longer half, and find the matching split in the other */
+    RandomIt cut1, cut2;
+    if(len1 > len2)
+    {
+      cut1 = first + len1 / 2;
+      cut2 = std::lower_bound(middle, last, *cut1, comp);
+    }
+    else
+    {
+      cut2 = middle + len2 / 2;
+      cut1 = std::upper_bound(first, middle, *cut2, comp);
+    }
+
+    RandomIt new_middle = std::rotate(cut1, middle, cut2);
+    merge_in_place(first, cut1, new_middle, comp);
+    merge_in_place(new_middle, cut2, last, comp);
+  }
+}
+
+/* Sorts [first, last) -- O(n log n), not stable */
+template<typename RandomIt, typename Compare>
+void sort(RandomIt first, RandomIt last, Compare comp)
+{
+  if(last - first < 2)
+    return;
+
+  /* Depth limit of 2*log2(n) */
+  unsigned depth_limit = 0;
+  for(std::ptrdiff_t n = last - first; n > 1; n >>= 1)
+    depth_limit += 2;
+
+  detail::introsort_loop(first, last, depth_limit, comp);
+  detail::insertion_sort(first, last, comp);
+}
+
+template<typename RandomIt>
+void sort(RandomIt first, RandomIt last)
+{ std::sort(first, last, detail::less()); }
+
+/* Sorts [first, last), keeping the order of equivalent elements -- O(n log^2 n), no allocation */
+template<typename RandomIt, typename Compare>
+void stable_sort(RandomIt first, RandomIt last, Compare comp)
+{
+  if(last - first <= detail::sort_threshold)
+  {
+    detail::insertion_sort(first, last, comp);
+    return;
+  }
+
+  RandomIt middle = first + (last - first) / 2;
+  std::stable_sort(first, middle, comp);
+  std::stable_sort(middle, last, comp);
+  detail::merge_in_place(first, middle, last, comp);
+}
+
+template<typename RandomIt>
+void stable_sort(RandomIt first, RandomIt last)
+{ std::stable_sort(first, last, detail::less()); }
+
+/* True if [first, last) is sorted */
+template<typename ForwardIt, typename Compare>
+constexpr bool is_sorted(ForwardIt first, ForwardIt last, Compare comp)
+{
+  if(first == last)
+    return true;
+
+  for(ForwardIt next = first; ++next != last; first = next)
+    if(comp(*next, *first))
+      return false;
+
+  return true;
+}
+
+template<typename ForwardIt>
+constexpr bool is_sorted(ForwardIt first, ForwardIt last)
+{ return std::is_sorted(first, last, detail::less()); }
+
 STL_END
@@ -34,14 +34,14 @@ struct array
    */
   constexpr reference at(size_type pos)
   {
-    if(pos > _size)
+    if(pos >= _size)
       apex::__break();
 
     return cArray[pos]; 
   }
   constexpr const_reference at(size_type pos) const
   {
-    if(pos > _size)
+    if(pos >= _size)
       apex::__break();
     
     return cArray[pos]; 
@@ -88,16 +88,22 @@ struct array
    * Iterators
    * @incomplete -- no reverse iterators
    */
-  iterator begin()
+  constexpr iterator begin()
   { return iterator(cArray); }
 
-  const_iterator cbegin() const
+  constexpr const_iterator begin() const
   { return const_iterator(cArray); }
 
-  iterator end()
+  constexpr const_iterator cbegin() const
+  { return const_iterator(cArray); }
+
+  constexpr iterator end()
   { return iterator(cArray + _size); }
 
-  const_iterator cend() const
+  constexpr const_iterator end() const
+  { return const_iterator(cArray + _size); }
+
+  constexpr const_iterator cend() const
   { return const_iterator(cArray + _size); }
 
   /**
@@ -115,16 +121,20 @@ struct array
   /**
    * Operations
    */
-  void fill(const T& val)
+  constexpr void fill(const T& val)
   {
     for(T& v : *this)
       v = val;
   }
 
-  void swap(array<T, _size>& other)
+  constexpr void swap(array<T, _size>& other)
   {
     for(size_t i = 0; i < size(); ++i)
-      std::swap((*this)[i], other[i]);
+    {
+      T temp = std::move((*this)[i]);
+      (*this)[i] = std::move(other[i]);
+      other[i] = std::move(temp);
+    }
   }
 
   /* Provide support for 0-size arrays */
@@ -136,13 +146,9 @@ struct array
  */
 
 template<typename T, size_t N>
-bool operator==(array<T, N>const& lhs, array<T, N>const& rhs)
+constexpr bool operator==(array<T, N>const& lhs, array<T, N>const& rhs)
 {
-  size_t s = lhs.size();
-  if(rhs.size() != s)
-    return false;
-
-  for(size_t i = 0; i < s; ++i)
+  for(size_t i = 0; i < N; ++i)
     if(!lexi::equal(lhs[i], rhs[i]))
       return false;
 
@@ -150,60 +156,34 @@ bool operator==(array<T, N>const& lhs, array<T, N>const& rhs)
 }
 
 template<typename T, size_t N>
-bool operator!=(array<T, N>const& lhs, array<T, N>const& rhs)
+constexpr bool operator!=(array<T, N>const& lhs, array<T, N>const& rhs)
 { return !(lhs == rhs); }
 
 template<typename T, size_t N>
-bool operator<(array<T, N>const& lhs, array<T, N>const& rhs)
+constexpr bool operator<(array<T, N>const& lhs, array<T, N>const& rhs)
 {
-  size_t lhs_s = lhs.size();
-  size_t rhs_s = rhs.size();
-
-  for(size_t i = 0; i < min(lhs_s, rhs_s); ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return lexi::less_than(lhs[i], rhs[i]);
+  for(size_t i = 0; i < N; ++i)
+  {
+    if(lhs[i] < rhs[i])
+      return true;
+    if(rhs[i] < lhs[i])
+      return false;
+  }
 
-  return lhs_s < rhs_s;
+  return false;
 }
 
 template<typename T, size_t N>
-bool operator<=(array<T, N>const& lhs, array<T, N>const& rhs)
-{
-  size_t lhs_s = lhs.size();
-  size_t rhs_s = rhs.size();
-
-  for(size_t i = 0; i < min(lhs_s, rhs_s); ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return lexi::less_or_equal(lhs[i], rhs[i]);
-
-  return lhs_s <= rhs_s;
-}
+constexpr bool operator<=(array<T, N>const& lhs, array<T, N>const& rhs)
+{ return !(rhs < lhs); }
 
 template<typename T, size_t N>
-bool operator>(array<T, N>const& lhs, array<T, N>const& rhs)
-{
-  size_t lhs_s = lhs.size();
-  size_t rhs_s = rhs.size();
-
-  for(size_t i = 0; i < min(lhs_s, rhs_s); ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return lexi::greater_than(lhs[i], rhs[i]);
-
-  return lhs_s > rhs_s;
-}
+constexpr bool operator>(array<T, N>const& lhs, array<T, N>const& rhs)
+{ return rhs < lhs; }
 
 template<typename T, size_t N>
-bool operator>=(array<T, N>const& lhs, array<T, N>const& rhs)
-{
-  size_t lhs_s = lhs.size();
-  size_t rhs_s = rhs.size();
-
-  for(size_t i = 0; i < min(lhs_s, rhs_s); ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return lexi::greater_or_equal(lhs[i], rhs[i]);
-
-  return lhs_s >= rhs_s;
-}
+constexpr bool operator>=(array<T, N>const& lhs, array<T, N>const& rhs)
+{ return !(lhs < rhs); }
 
 /**
  * Non-member functions
@@ -222,8 +202,29 @@ constexpr const T& get(const array<T,N>& a)
   return a[I];
 }
 
+template<std::size_t I, typename T, std::size_t N>
+constexpr T&& get(array<T,N>&& a)
+{
+  static_assert(I < N, "std::get(std::array) invoked with I >= N");
+  return std::move(a[I]);
+}
+
 template<typename T, std::size_t N>
-void swap(array<T,N>& lhs, array<T,N>& rhs)
+constexpr void swap(array<T,N>& lhs, array<T,N>& rhs)
 { lhs.swap(rhs); }
 
+/**
+ * Tuple interface (enables structured bindings)
+ */
+template<typename T, std::size_t N>
+class tuple_size<array<T,N>> : public integral_constant<std::size_t, N>
+{ };
+
+template<std::size_t I, typename T, std::size_t N>
+struct tuple_element<I, array<T,N>>
+{
+  static_assert(I < N, "std::tuple_element(std::array) invoked with I >= N");
+  using type = T;
+};
+
 STL_END
@@ -1,16 +1,86 @@
 #include "cstring"
 
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * The copy/fill loops are written with string instructions, which
+ *  - are fast on anything with ERMSB (and never slow for small counts)
+ *  - can't be pattern-matched by GCC back into a call to themselves
+ */
 STL_BEGIN
 
 void* memcpy(void* d, void const* s, std::size_t count)
 {
-  char* dest = reinterpret_cast<char*>(d);
-  char const* src = reinterpret_cast<char const*>(s);
+  void* dest = d;
+
+  /* Dwords first, then the remaining 0-3 bytes */
+  std::size_t dwords = count / 4;
+  asm volatile("rep movsl"
+               : "+D"(dest), "+S"(s), "+c"(dwords)
+               :
+               : "memory");
 
-  while(count--)
-    *(dest++) = *(src++);
+  std::size_t bytes = count % 4;
+  asm volatile("rep movsb"
+               : "+D"(dest), "+S"(s), "+c"(bytes)
+               :
+               : "memory");
 
   return d;
 }
 
+void* memmove(void* d, void const* s, std::size_t count)
+{
+  uintptr_t dest = reinterpret_cast<uintptr_t>(d);
+  uintptr_t src = reinterpret_cast<uintptr_t>(s);
+
+  /* Forward copies are safe unless dest starts inside [src, src+count) */
+  if(dest - src >= count)
+    return memcpy(d, s, count);
+
+  /* Copy backwards, starting from the last byte */
+  void* dest_last = reinterpret_cast<void*>(dest + count - 1);
+  void const* src_last = reinterpret_cast<void const*>(src + count - 1);
+  asm volatile("std\n\t"
+               "rep movsb\n\t"
+               "cld"
+               : "+D"(dest_last), "+S"(src_last), "+c"(count)
+               :
+               : "memory");
+
+  return d;
+}
+
+void* memset(void* d, int ch, std::size_t count)
+{
+  void* dest = d;
+  asm volatile("rep stosb"
+               : "+D"(dest), "+c"(count)
+               : "a"(ch)
+               : "memory");
+
+  return d;
+}
+
+/* A dword that may alias anything and sit at any alignment */
+using loose_dword = uint32_t __attribute__((may_alias, aligned(1)));
+
+int memcmp(void const* l, void const* r, std::size_t count)
+{
+  unsigned char const* lhs = reinterpret_cast<unsigned char const*>(l);
+  unsigned char const* rhs = reinterpret_cast<unsigned char const*>(r);
+
+  /* Skip equal dwords quickly, then find the differing byte */
+  for(; count >= 4; count -= 4, lhs += 4, rhs += 4)
+    if(*reinterpret_cast<loose_dword const*>(lhs) != *reinterpret_cast<loose_dword const*>(rhs))
+      break;
+
+  for(; count; --count, ++lhs, ++rhs)
+    if(*lhs != *rhs)
+      return *lhs < *rhs ? -1 : 1;
+
+  return 0;
+}
+
 STL_END
@@ -8,12 +8,47 @@
 STL_BEGIN
 
 /**
- * The well-defined memcpy function
- *
- * @param dest    Where to put copy
- * @param src     Where to copy from
- * @param count   Amount to copy
+ * These use C linkage, so they also satisfy the calls GCC may emit on its own
+ *   (struct copies, zero-initialization) even in a freestanding build
  */
-void* memcpy(void* dest, void const* src, std::size_t count);
+extern "C"
+{
+  /**
+   * The well-defined memcpy function
+   *
+   * @param dest    Where to put copy
+   * @param src     Where to copy from
+   * @param count   Amount to copy
+   */
+  void* memcpy(void* dest, void const* src, std::size_t count);
+
+  /**
+   * The well-defined memmove function -- memcpy, but the ranges may overlap
+   *
+   * @param dest    Where to put copy
+   * @param src     Where to copy from
+   * @param count   Amount to copy
+   */
+  void* memmove(void* dest, void const* src, std::size_t count);
+
+  /**
+   * The well-defined memset function
+   *
+   * @param dest    The memory to fill
+   * @param ch      The value to fill with (converted to unsigned char)
+   * @param count   Amount to fill
+   */
+  void* memset(void* dest, int ch, std::size_t count);
+
+  /**
+   * The well-defined memcmp function
+   *
+   * @param lhs     The first buffer
+   * @param rhs     The second buffer
+   * @param count   Amount to compare
+   * @return        <0, 0, or >0 as the first differing (unsigned) byte compares
+   */
+  int memcmp(void const* lhs, void const* rhs, std::size_t count);
+}
 
 STL_END
@@ -0,0 +1,183 @@
+#pragma once
+
+/* STL */
+#include "array"
+#include "cstddef"
+#include "libstl"
+#include "vector"
+
+/* APEX */
+#include <helpers>
+
+STL_BEGIN
+
+/* Extent value for spans whose size is only known at runtime */
+constexpr std::size_t dynamic_extent = static_cast<std::size_t>(-1);
+
+/**
+ * @class std::span
+ * @brief A non-owning pointer+length view of contiguous objects
+ *
+ * Note: The extent is only checked on construction, the size is always stored.
+ *
+ * http://en.cppreference.com/w/cpp/container/span
+ */
+template<typename T, std::size_t Extent = dynamic_extent>
+class span
+{
+public:
+  /*
+   * Member types
+   */
+  using element_type = T;
+  using value_type = typename remove_cv<T>::type;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using const_pointer = T const*;
+  using reference = T&;
+  using const_reference = T const&;
+  using iterator = pointer;
+  static constexpr size_type extent = Extent;
+
+  /**
+   * Constructors
+   */
+
+  /* Constructs an empty span */
+  constexpr span()
+  :ptr(nullptr)
+  ,len(0)
+  {
+    static_assert(Extent == 0 || Extent == dynamic_extent, "Only empty or dynamic spans are default constructable");
+  }
+
+  /* Spans count elements starting at first */
+  constexpr span(pointer first, size_type count)
+  :ptr(first)
+  ,len(count)
+  {
+    if(Extent != dynamic_extent && count != Extent)
+      apex::__break();
+  }
+
+  /* Spans [first, last) */
+  constexpr span(pointer first, pointer last)
+  :span(first, static_cast<size_type>(last - first))
+  { }
+
+  /* Spans a c-style array */
+  template<std::size_t N>
+  constexpr span(element_type (&arr)[N])
+  :span(arr, N)
+  { }
+
+  /* Spans a std::array */
+  template<typename U, std::size_t N>
+  constexpr span(array<U, N>& arr)
+  :span(arr.data(), N)
+  { }
+
+  template<typename U, std::size_t N>
+  constexpr span(array<U, N> const& arr)
+  :span(arr.data(), N)
+  { }
+
+  /* Spans the current contents of a std::vector */
+  template<typename U>
+  span(vector<U>& vec)
+  :span(vec.data(), vec.size())
+  { }
+
+  template<typename U>
+  span(vector<U> const& vec)
+  :span(vec.data(), vec.size())
+  { }
+
+  /* Conversion between compatible spans (i.e. span<T> -> span<T const>) */
+  template<typename U, std::size_t N>
+  constexpr span(span<U, N> const& other)
+  :span(other.data(), other.size())
+  { }
+
+  constexpr span(span const& other) = default;
+  constexpr span& operator=(span const& other) = default;
+
+  /**
+   * Element access
+   */
+  constexpr reference operator[](size_type pos) const
+  { return ptr[pos]; }
+
+  constexpr reference front() const
+  { return ptr[0]; }
+
+  constexpr reference back() const
+  { return ptr[len - 1]; }
+
+  constexpr pointer data() const
+  { return ptr; }
+
+  /**
+   * Iterators
+   */
+  constexpr iterator begin() const
+  { return ptr; }
+
+  constexpr iterator end() const
+  { return ptr + len; }
+
+  /**
+   * Observers
+   */
+  constexpr size_type size() const
+  { return len; }
+
+  constexpr size_type size_bytes() const
+  { return len * sizeof(element_type); }
+
+  constexpr bool empty() const
+  { return len == 0; }
+
+  /**
+   * Subviews
+   */
+
+  /* The first count elements */
+  constexpr span<T> first(size_type count) const
+  {
+    if(count > len)
+      apex::__break();
+
+    return span<T>(ptr, count);
+  }
+
+  /* The last count elements */
+  constexpr span<T> last(size_type count) const
+  {
+    if(count > len)
+      apex::__break();
+
+    return span<T>(ptr + (len - count), count);
+  }
+
+  /* The elements [offset, offset+count), clamped to the end of the span */
+  constexpr span<T> subspan(size_type offset, size_type count = dynamic_extent) const
+  {
+    if(offset > len)
+      apex::__break();
+
+    if(count > len - offset)
+      count = len - offset;
+
+    return span<T>(ptr + offset, count);
+  }
+
+private:
+  /* The first element */
+  pointer ptr;
+  /* The number of elements */
+  size_type len;
+};
+
+STL_END
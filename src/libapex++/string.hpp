@@ -2,6 +2,7 @@
 
 #include "cstddef"
 #include "libstl"
+#include "string_view"
 #include "vector"
 
 STL_BEGIN
@@ -64,25 +65,26 @@ public:
 
   /* From c-string constructor */
   string(char const* str)
-  {
-    size_type size = 0;
-    for(char const* s = str; *s; ++s)
-      ++size;
+  :string(string_view(str))
+  { }
 
-    reserve(size);
+  /* From character range constructor */
+  string(char const* str, size_type count)
+  {
+    reserve(count + 1);
+    data_vec.insert(data_vec.end(), str, str + count);
     push_null();
-    for(char const* s = str; *s; ++s)
-      push_back(*s);
   }
 
+  /* From string_view constructor */
+  explicit string(string_view sv)
+  :string(sv.data(), sv.size())
+  { }
+
   /* Copy constructor */
   string(string const& other)
-  {
-    reserve(other.capacity());
-    push_null();
-    for(char c : other)
-      push_back(c);
-  }
+  :string(other.data(), other.size())
+  { }
 
   /* Move constructor */
   string(string&& other)
@@ -106,6 +108,8 @@ public:
 
   string& operator=(char const* other)
   { return assign(other); }
+  string& operator=(string_view other)
+  { return assign(other); }
   string& operator=(string const& other)
   { return assign(other); }
   string& operator=(string&& other)
@@ -144,6 +148,10 @@ public:
   const_pointer c_str() const
   { return data(); }
 
+  /* Views the string without copying it */
+  operator string_view() const
+  { return string_view(data(), size()); }
+
   /**
    * Iterators
    */
@@ -264,10 +272,12 @@ public:
 
   /* Appends the given string */
   string& append(string const& str)
-  {
-    for(char c : str)
-      push_back(c);
+  { return append(string_view(str)); }
 
+  /* Appends the given character range */
+  string& append(string_view sv)
+  {
+    data_vec.insert(end(), sv.begin(), sv.end());
     return *this;
   }
 
@@ -283,12 +293,7 @@ public:
 
   /* Appends the given c-style string */
   string& append(char const* str)
-  {
-    while(*str)
-      push_back(*(str++));
-
-    return *this;
-  }
+  { return append(string_view(str)); }
 
   /* Operator += for all of the above */
   template<typename T>
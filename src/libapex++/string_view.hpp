@@ -0,0 +1,249 @@
+#pragma once
+
+#include "cstddef"
+#include "libstl"
+
+/* APEX */
+#include <helpers>
+#include <stack_string>
+
+STL_BEGIN
+
+/**
+ * @class std::string_view
+ * @brief A non-owning pointer+length view of characters, based on the ISO std::basic_string_view<char>
+ *
+ * Note: Like std::string, this is only implemented for char.
+ *
+ * http://en.cppreference.com/w/cpp/string/basic_string_view
+ */
+class string_view
+{
+public:
+  /*
+   * Member types
+   */
+  using value_type = char;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = char&;
+  using const_reference = char const&;
+  using pointer = char*;
+  using const_pointer = char const*;
+  using iterator = const_pointer;
+  using const_iterator = const_pointer;
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  /**
+   * Constructors and Assignment
+   */
+
+  /* Constructs an empty view */
+  constexpr string_view()
+  :str(nullptr)
+  ,len(0)
+  { }
+
+  /* Views count characters starting at s */
+  constexpr string_view(char const* s, size_type count)
+  :str(s)
+  ,len(count)
+  { }
+
+  /* Views a null-terminated string (scans it once) */
+  constexpr string_view(char const* s)
+  :str(s)
+  ,len(length(s))
+  { }
+
+  /* Views the contents of an apex::stack_string */
+  string_view(apex::stack_string const& s)
+  :str(s.c_str())
+  ,len(s.size())
+  { }
+
+  constexpr string_view(string_view const& other) = default;
+  constexpr string_view& operator=(string_view const& other) = default;
+
+  /**
+   * Element access
+   */
+  constexpr const_reference operator[](size_type pos) const
+  { return str[pos]; }
+
+  constexpr const_reference at(size_type pos) const
+  {
+    if(pos >= len)
+      apex::__break();
+
+    return str[pos];
+  }
+
+  constexpr const_reference front() const
+  { return str[0]; }
+
+  constexpr const_reference back() const
+  { return str[len - 1]; }
+
+  /* Note: not necessarily null-terminated */
+  constexpr const_pointer data() const
+  { return str; }
+
+  /**
+   * Iterators
+   */
+  constexpr const_iterator begin() const
+  { return str; }
+  constexpr const_iterator cbegin() const
+  { return str; }
+
+  constexpr const_iterator end() const
+  { return str + len; }
+  constexpr const_iterator cend() const
+  { return str + len; }
+
+  /**
+   * Capacity
+   */
+  constexpr size_type size() const
+  { return len; }
+  constexpr size_type length() const
+  { return len; }
+
+  constexpr bool empty() const
+  { return len == 0; }
+
+  /**
+   * Modifiers
+   */
+  constexpr void remove_prefix(size_type n)
+  {
+    str += n;
+    len -= n;
+  }
+
+  constexpr void remove_suffix(size_type n)
+  { len -= n; }
+
+  constexpr void swap(string_view& other)
+  {
+    string_view temp = *this;
+    *this = other;
+    other = temp;
+  }
+
+  /**
+   * Operations
+   */
+
+  /* Sub-view [pos, pos+count), clamped to the end of the view */
+  constexpr string_view substr(size_type pos = 0, size_type count = npos) const
+  {
+    if(pos > len)
+      apex::__break();
+
+    if(count > len - pos)
+      count = len - pos;
+
+    return string_view(str + pos, count);
+  }
+
+  /* Lexicographic comparison, <0, 0, or >0 */
+  constexpr int compare(string_view other) const
+  {
+    size_type n = len < other.len ? len : other.len;
+    for(size_type i = 0; i < n; ++i)
+    {
+      if(str[i] != other.str[i])
+        return static_cast<unsigned char>(str[i]) < static_cast<unsigned char>(other.str[i]) ? -1 : 1;
+    }
+
+    if(len == other.len)
+      return 0;
+
+    return len < other.len ? -1 : 1;
+  }
+
+  constexpr bool starts_with(string_view prefix) const
+  { return len >= prefix.len && substr(0, prefix.len).compare(prefix) == 0; }
+
+  constexpr bool ends_with(string_view suffix) const
+  { return len >= suffix.len && substr(len - suffix.len).compare(suffix) == 0; }
+
+  /* Index of the first c at or after pos, or npos */
+  constexpr size_type find(char c, size_type pos = 0) const
+  {
+    for(; pos < len; ++pos)
+      if(str[pos] == c)
+        return pos;
+
+    return npos;
+  }
+
+  /* Index of the first occurrence of v at or after pos, or npos */
+  constexpr size_type find(string_view v, size_type pos = 0) const
+  {
+    if(v.len > len)
+      return npos;
+
+    for(; pos <= len - v.len; ++pos)
+      if(substr(pos, v.len).compare(v) == 0)
+        return pos;
+
+    return npos;
+  }
+
+  /* Index of the last c at or before pos, or npos */
+  constexpr size_type rfind(char c, size_type pos = npos) const
+  {
+    if(!len)
+      return npos;
+
+    if(pos >= len)
+      pos = len - 1;
+
+    for(size_type i = pos + 1; i-- > 0;)
+      if(str[i] == c)
+        return i;
+
+    return npos;
+  }
+
+private:
+  /* Length of a null-terminated string */
+  static constexpr size_type length(char const* s)
+  {
+    size_type l = 0;
+    while(s[l])
+      ++l;
+    return l;
+  }
+
+  /* The first viewed character */
+  const_pointer str;
+  /* The number of viewed characters */
+  size_type len;
+};
+
+/**
+ * Lexicographic comparisons
+ */
+constexpr bool operator==(string_view lhs, string_view rhs)
+{ return lhs.size() == rhs.size() && lhs.compare(rhs) == 0; }
+
+constexpr bool operator!=(string_view lhs, string_view rhs)
+{ return !(lhs == rhs); }
+
+constexpr bool operator<(string_view lhs, string_view rhs)
+{ return lhs.compare(rhs) < 0; }
+
+constexpr bool operator<=(string_view lhs, string_view rhs)
+{ return lhs.compare(rhs) <= 0; }
+
+constexpr bool operator>(string_view lhs, string_view rhs)
+{ return lhs.compare(rhs) > 0; }
+
+constexpr bool operator>=(string_view lhs, string_view rhs)
+{ return lhs.compare(rhs) >= 0; }
+
+STL_END
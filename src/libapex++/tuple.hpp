@@ -1,5 +1,6 @@
 #pragma once
 
+#include "algorithm"
 #include "cstddef"
 #include "libstl"
 #include "utility_forward"
@@ -21,7 +22,12 @@ class tuple
   template<std::size_t i>
   struct get_helper{ };
 public:
-  tuple(const T& _t, const Us&... us)
+  constexpr tuple()
+  :t()
+  ,sub()
+  { }
+
+  constexpr tuple(const T& _t, const Us&... us)
   :t(_t)
   ,sub(us...)
   { }
@@ -32,25 +38,25 @@ public:
    *  still deduce correctly
    */
   template<std::size_t indx>
-  auto& get()
+  constexpr auto& get()
   { return get_impl(get_helper<indx>()); }
   template<std::size_t indx>
-  auto const& get() const
+  constexpr auto const& get() const
   { return get_impl(get_helper<indx>()); }
 
 private:
   /* Index OOB -- return subclass[indx-1] */
   template<std::size_t indx>
-  auto& get_impl(get_helper<indx>)
+  constexpr auto& get_impl(get_helper<indx>)
   { return sub.template get<indx-1>(); }
   template<std::size_t indx>
-  auto& get_impl(get_helper<indx>) const
+  constexpr auto& get_impl(get_helper<indx>) const
   { return sub.template get<indx-1>(); }
 
   /* 0 requested -- return our value */
-  T& get_impl(get_helper<0>)
+  constexpr T& get_impl(get_helper<0>)
   { return std::forward<T&>(t); }
-  T const& get_impl(get_helper<0>) const
+  constexpr T const& get_impl(get_helper<0>) const
   { return std::forward<T const&>(t); }
 
   /* The value this tuple holds */
@@ -67,7 +73,12 @@ class tuple<T, U>
   template<std::size_t i>
   struct get_helper{ };
 public:
-  tuple(const T& _t, const U& _u)
+  constexpr tuple()
+  :t()
+  ,u()
+  { }
+
+  constexpr tuple(const T& _t, const U& _u)
   :t(_t)
   ,u(_u)
   { }
@@ -78,10 +89,10 @@ public:
    *  still deduce correctly
    */
   template<std::size_t indx>
-  auto& get()
+  constexpr auto& get()
   { return get_impl(get_helper<indx>()); }
   template<std::size_t indx>
-  auto const& get() const
+  constexpr auto const& get() const
   { return get_impl(get_helper<indx>()); }
 
 private:
@@ -94,15 +105,15 @@ private:
   void get_impl(get_helper<indx>) const;
 
   /* 0 requested -- return our value */
-  T& get_impl(get_helper<0>)
+  constexpr T& get_impl(get_helper<0>)
   { return std::forward<T&>(t); }
-  T const& get_impl(get_helper<0>) const
+  constexpr T const& get_impl(get_helper<0>) const
   { return std::forward<T const&>(t); }
 
   /* 1 requested -- return our value */
-  U& get_impl(get_helper<1>)
+  constexpr U& get_impl(get_helper<1>)
   { return std::forward<U&>(u); }
-  U const& get_impl(get_helper<1>) const
+  constexpr U const& get_impl(get_helper<1>) const
   { return std::forward<U const&>(u); }
 
   T t;
@@ -117,7 +128,11 @@ class tuple<T>
   template<std::size_t i>
   struct get_helper{ };
 public:
-  tuple(const T& _t)
+  constexpr tuple()
+  :t()
+  { }
+
+  constexpr tuple(const T& _t)
   :t(_t)
   { }
 
@@ -127,10 +142,10 @@ public:
    *  still deduce correctly
    */
   template<std::size_t indx>
-  auto& get()
+  constexpr auto& get()
   { return get_impl(get_helper<indx>()); }
   template<std::size_t indx>
-  auto const& get() const
+  constexpr auto const& get() const
   { return get_impl(get_helper<indx>()); }
 
 private:
@@ -142,9 +157,9 @@ private:
   void get_impl(get_helper<indx>) const;
 
   /* 0 requested -- return our value */
-  T& get_impl(get_helper<0>)
+  constexpr T& get_impl(get_helper<0>)
   { return std::forward<T&>(t); }
-  T const& get_impl(get_helper<0>) const
+  constexpr T const& get_impl(get_helper<0>) const
   { return std::forward<T const&>(t); }
 
   T t;
@@ -152,16 +167,16 @@ private:
 
 /* Non-member std::get */
 template<std::size_t indx, typename... Ts>
-auto& get(tuple<Ts...>& t)
+constexpr auto& get(tuple<Ts...>& t)
 { return t.template get<indx>(); }
 
 template<std::size_t indx, typename... Ts>
-auto const& get(tuple<Ts...> const& t)
+constexpr auto const& get(tuple<Ts...> const& t)
 { return t.template get<indx>(); }
 
 /* Convenience make_tuple */
 template<typename... Ts>
-auto make_tuple(Ts... args)
+constexpr auto make_tuple(Ts... args)
 { return tuple<Ts...>(args...); }
 
 /* Size of tuple */
@@ -173,4 +188,93 @@ template<typename... Ts>
 class tuple_size<tuple<Ts...>> : public integral_constant<std::size_t, sizeof...(Ts)>
 { };
 
+template<typename T>
+class tuple_size<T const> : public integral_constant<std::size_t, tuple_size<T>::value>
+{ };
+
+/* Type of the indx'th element of a tuple-like type */
+template<std::size_t indx, typename T>
+struct tuple_element;
+
+template<std::size_t indx, typename T, typename... Us>
+struct tuple_element<indx, tuple<T, Us...>> : public tuple_element<indx-1, tuple<Us...>>
+{ };
+
+template<typename T, typename... Us>
+struct tuple_element<0, tuple<T, Us...>>
+{ using type = T; };
+
+template<std::size_t indx, typename T>
+struct tuple_element<indx, T const>
+{ using type = typename tuple_element<indx, T>::type const; };
+
+/**
+ * Lexicographic comparisons (only using <, like the rest of the STL)
+ */
+namespace detail
+{
+  template<std::size_t indx, std::size_t size>
+  struct tuple_compare
+  {
+    template<typename T, typename U>
+    static constexpr bool equal(T const& lhs, U const& rhs)
+    {
+      return lexi::equal(lhs.template get<indx>(), rhs.template get<indx>()) &&
+             tuple_compare<indx+1, size>::equal(lhs, rhs);
+    }
+
+    template<typename T, typename U>
+    static constexpr bool less(T const& lhs, U const& rhs)
+    {
+      if(lhs.template get<indx>() < rhs.template get<indx>())
+        return true;
+      if(rhs.template get<indx>() < lhs.template get<indx>())
+        return false;
+      return tuple_compare<indx+1, size>::less(lhs, rhs);
+    }
+  };
+
+  template<std::size_t size>
+  struct tuple_compare<size, size>
+  {
+    template<typename T, typename U>
+    static constexpr bool equal(T const&, U const&)
+    { return true; }
+
+    template<typename T, typename U>
+    static constexpr bool less(T const&, U const&)
+    { return false; }
+  };
+}
+
+template<typename... Ts, typename... Us>
+constexpr bool operator==(tuple<Ts...> const& lhs, tuple<Us...> const& rhs)
+{
+  static_assert(sizeof...(Ts) == sizeof...(Us), "Cannot compare tuples of different sizes");
+  return detail::tuple_compare<0, sizeof...(Ts)>::equal(lhs, rhs);
+}
+
+template<typename... Ts, typename... Us>
+constexpr bool operator!=(tuple<Ts...> const& lhs, tuple<Us...> const& rhs)
+{ return !(lhs == rhs); }
+
+template<typename... Ts, typename... Us>
+constexpr bool operator<(tuple<Ts...> const& lhs, tuple<Us...> const& rhs)
+{
+  static_assert(sizeof...(Ts) == sizeof...(Us), "Cannot compare tuples of different sizes");
+  return detail::tuple_compare<0, sizeof...(Ts)>::less(lhs, rhs);
+}
+
+template<typename... Ts, typename... Us>
+constexpr bool operator<=(tuple<Ts...> const& lhs, tuple<Us...> const& rhs)
+{ return !(rhs < lhs); }
+
+template<typename... Ts, typename... Us>
+constexpr bool operator>(tuple<Ts...> const& lhs, tuple<Us...> const& rhs)
+{ return rhs < lhs; }
+
+template<typename... Ts, typename... Us>
+constexpr bool operator>=(tuple<Ts...> const& lhs, tuple<Us...> const& rhs)
+{ return !(lhs < rhs); }
+
 STL_END
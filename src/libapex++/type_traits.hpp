@@ -115,6 +115,17 @@ template<typename T>
 struct add_cv
 { using type = typename add_const<typename add_volatile<T>::type>::type; };
 
+/**
+ * Evaluates to true_type if T and U are the same type
+ */
+template<typename T, typename U>
+struct is_same : public false_type
+{ };
+
+template<typename T>
+struct is_same<T, T> : public true_type
+{ };
+
 /**
  * Evaluates to true_type if the given type is void
  */
@@ -141,6 +152,10 @@ template<>
 struct is_integral<char> : public true_type
 { };
 
+template<>
+struct is_integral<signed char> : public true_type
+{ };
+
 template<>
 struct is_integral<unsigned char> : public true_type
 { };
@@ -165,6 +180,10 @@ template<>
 struct is_integral<short> : public true_type
 { };
 
+template<>
+struct is_integral<int> : public true_type
+{ };
+
 template<>
 struct is_integral<unsigned int> : public true_type
 { };
@@ -223,8 +242,12 @@ struct is_member_function_pointer : detail::is_mem_fn_ptr_helper<typename std::r
 { };
 
 /**
- * is_{enum,union,class} all require a little help from the compiler
+ * is_{enum,union,class,trivially_copyable} all require a little help from the compiler
  */
+template<typename T>
+struct is_trivially_copyable : public bool_constant<__is_trivially_copyable(T)>
+{ };
+
 template<typename T>
 struct is_enum : public bool_constant<__is_enum(T)>
 { };
@@ -172,31 +172,50 @@ namespace detail
   template<size_t index>
   struct pair_get_index_t {};
 
-  template<size_t index, typename T1, typename T2>
-  void pair_get_impl(pair<T1,T2>& p, pair_get_index_t<index>);
-
   template<typename T1, typename T2>
-  auto& pair_get_impl(pair<T1,T2>& p, pair_get_index_t<0>)
+  constexpr auto& pair_get_impl(pair<T1,T2>& p, pair_get_index_t<0>)
   { return p.first; }
   template<typename T1, typename T2>
-  auto const& pair_get_impl(pair<T1,T2> const& p, pair_get_index_t<0>)
+  constexpr auto const& pair_get_impl(pair<T1,T2> const& p, pair_get_index_t<0>)
   { return p.first; }
 
   template<typename T1, typename T2>
-  auto& pair_get_impl(pair<T1,T2>& p, pair_get_index_t<1>)
+  constexpr auto& pair_get_impl(pair<T1,T2>& p, pair_get_index_t<1>)
   { return p.second; }
   template<typename T1, typename T2>
-  auto const& pair_get_impl(pair<T1,T2> const& p, pair_get_index_t<1>)
+  constexpr auto const& pair_get_impl(pair<T1,T2> const& p, pair_get_index_t<1>)
   { return p.second; }
 }
 
 template<size_t index, typename T1, typename T2>
-auto& get(pair<T1,T2>& p)
-{ return detail::pair_get_impl<index>(p, detail::pair_get_index_t<index>()); }
+constexpr auto& get(pair<T1,T2>& p)
+{ return detail::pair_get_impl(p, detail::pair_get_index_t<index>()); }
+
+template<size_t index, typename T1, typename T2>
+constexpr auto const& get(pair<T1,T2> const& p)
+{ return detail::pair_get_impl(p, detail::pair_get_index_t<index>()); }
 
 /* Tuple_size helper */
 template<typename T1, typename T2>
 class tuple_size<pair<T1,T2>> : public integral_constant<size_t, 2>
 { };
 
+/* Tuple_element helper */
+template<typename T1, typename T2>
+struct tuple_element<0, pair<T1,T2>>
+{ using type = T1; };
+
+template<typename T1, typename T2>
+struct tuple_element<1, pair<T1,T2>>
+{ using type = T2; };
+
+/* Rvalue get (after tuple_element, which names the result) -- needed by structured bindings */
+template<size_t index, typename T1, typename T2>
+constexpr typename tuple_element<index, pair<T1,T2>>::type&& get(pair<T1,T2>&& p)
+{ return std::forward<typename tuple_element<index, pair<T1,T2>>::type>(get<index>(p)); }
+
+template<size_t index, typename T1, typename T2>
+constexpr typename tuple_element<index, pair<T1,T2>>::type const&& get(pair<T1,T2> const&& p)
+{ return std::forward<typename tuple_element<index, pair<T1,T2>>::type const>(get<index>(p)); }
+
 STL_END
@@ -20,11 +20,11 @@ namespace detail
 };
 
 template<typename T>
-T&& forward(typename remove_reference<T>::type& ref)
+constexpr T&& forward(typename remove_reference<T>::type& ref)
 { return static_cast<typename detail::identity<T>::type&&>(ref); }
 
 template<typename T>
-T&& forward(typename remove_reference<T>::type&& ref)
+constexpr T&& forward(typename remove_reference<T>::type&& ref)
 { return static_cast<typename detail::identity<T>::type&&>(ref); }
 
 /**
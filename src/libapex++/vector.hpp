@@ -263,6 +263,49 @@ public:
   iterator insert(const_iterator it, const_reference val)
   { return emplace(it, val); }
 
+  /**
+   * Inserts copies of [first, last) before it (random-access iterators only)
+   * The range may come from this vector (i.e. string::append of itself)
+   */
+  template<typename InputIt>
+  iterator insert(const_iterator it, InputIt first, InputIt last)
+  {
+    difference_type indx = it - begin();
+    size_t count = last - first;
+
+    /* The reservation (or the shift) would move the range under the copy, so copy it out first */
+    if constexpr(is_pointer<InputIt>::value)
+      if(count && overlaps(&*first, count))
+      {
+        vector copy;
+        copy.insert(copy.end(), first, last);
+        return insert(begin() + indx, copy.begin(), copy.end());
+      }
+
+    /* Make a single reservation for the whole range */
+    if(size() + count > capacity())
+      reserve(max(size() * 2 + 1, size() + count));
+
+    T* pos = data_start + indx;
+
+    /* Move all elements after `pos` back by count */
+    for(T* ptr = data_last; ptr > pos; --ptr)
+    {
+      T* src = ptr - 1;
+      T* dst = src + count;
+
+      new (dst) T(std::move(*src));
+      destroy(*src);
+    }
+
+    /* Construct the new elements */
+    for(T* dst = pos; first != last; ++first, ++dst)
+      new (dst) T(*first);
+
+    data_last += count;
+    return pos;
+  }
+
   /** Constructs an element in-place */
   template<typename... Ctor_Args>
   iterator emplace(const_iterator it, Ctor_Args... args)
@@ -405,6 +448,14 @@ private:
   static typename enable_if<!is_destructable<_T>::value>::type destroy(_T& element)
   { }
 
+  /* True if count elements from p are in this vector's allocation */
+  bool overlaps(void const* p, size_t count) const
+  {
+    uintptr_t first = reinterpret_cast<uintptr_t>(p);
+    return first < reinterpret_cast<uintptr_t>(data_end) &&
+           first + count * sizeof(T) > reinterpret_cast<uintptr_t>(data_start);
+  }
+
   /* Start to the beginning of allocated data */
   T* data_start;
   /* Element-after the last initialized element */
@@ -420,15 +471,11 @@ private:
 template<typename T, typename U>
 bool operator==(vector<T> const& lhs, vector<U> const& rhs)
 {
-  size_t s = lhs.size();
-  if(rhs.size() != s)
+  if(lhs.size() != rhs.size())
     return false;
 
-  for(size_t i = 0; i < s; ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return false;
-
-  return true;
+  /* Trivial element types compare with a single memcmp */
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
 template<typename T, typename U>
@@ -437,55 +484,19 @@ bool operator!=(vector<T> const& lhs, vector<U> const& rhs)
 
 template<typename T, typename U>
 bool operator<(vector<T> const& lhs, vector<U> const& rhs)
-{
-  size_t lhs_s = lhs.size();
-  size_t rhs_s = rhs.size();
-
-  for(size_t i = 0; i < min(lhs_s, rhs_s); ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return lexi::less_than(lhs[i], rhs[i]);
-
-  return lhs_s < rhs_s;
-}
+{ return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
 
 template<typename T, typename U>
 bool operator<=(vector<T> const& lhs, vector<U> const& rhs)
-{
-  size_t lhs_s = lhs.size();
-  size_t rhs_s = rhs.size();
-
-  for(size_t i = 0; i < min(lhs_s, rhs_s); ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return lexi::less_or_equal(lhs[i], rhs[i]);
-
-  return lhs_s <= rhs_s;
-}
+{ return !(rhs < lhs); }
 
 template<typename T, typename U>
 bool operator>(vector<T> const& lhs, vector<U> const& rhs)
-{
-  size_t lhs_s = lhs.size();
-  size_t rhs_s = rhs.size();
-
-  for(size_t i = 0; i < min(lhs_s, rhs_s); ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return lexi::greater_than(lhs[i], rhs[i]);
-
-  return lhs_s > rhs_s;
-}
+{ return rhs < lhs; }
 
 template<typename T, typename U>
 bool operator>=(vector<T> const& lhs, vector<U> const& rhs)
-{
-  size_t lhs_s = lhs.size();
-  size_t rhs_s = rhs.size();
-
-  for(size_t i = 0; i < min(lhs_s, rhs_s); ++i)
-    if(!lexi::equal(lhs[i], rhs[i]))
-      return lexi::greater_or_equal(lhs[i], rhs[i]);
-
-  return lhs_s >= rhs_s;
-}
+{ return !(lhs < rhs); }
 
 /* Swap Specialization */
 template<typename T>
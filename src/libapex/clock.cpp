@@ -0,0 +1,40 @@
+#include "clock"
+
+APEX_BEGIN
+
+namespace clock
+{
+  /* TSC ticks per millisecond */
+  static uint32_t khz;
+
+  /* The TSC at calibration (now() == 0) */
+  static uint64_t base;
+
+  /* Calibration */
+  void calibrate(uint32_t _khz)
+  {
+    base = rdtsc();
+    khz = _khz;
+  }
+
+  /* Frequency accessor */
+  uint32_t tsc_khz()
+  { return khz; }
+
+  /* Ticks -> ns, split so ticks * 1000000 can't overflow */
+  uint64_t to_ns(uint64_t ticks)
+  {
+    if(!khz)
+      return 0;
+
+    uint64_t ms = ticks / khz;
+    uint64_t rem = ticks % khz;
+    return ms * 1000000 + (rem * 1000000) / khz;
+  }
+
+  /* Current time */
+  uint64_t now()
+  { return to_ns(rdtsc() - base); }
+}
+
+APEX_END
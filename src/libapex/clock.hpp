@@ -0,0 +1,51 @@
+#pragma once
+
+/* APEX */
+#include "libapex"
+
+/* Compiler */
+#include <stdint.h>
+
+APEX_BEGIN
+
+/**
+ * A monotonic, tickless clock based on the time stamp counter
+ *
+ * The kernel calibrates it against the PIT during boot,
+ *   until then now() reads 0.
+ */
+namespace clock
+{
+  /* Reads the raw time stamp counter */
+  inline uint64_t rdtsc()
+  {
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+  }
+
+  /**
+   * Sets the TSC frequency, and starts now() counting from 0
+   *
+   * @param khz   TSC ticks per millisecond
+   */
+  void calibrate(uint32_t khz);
+
+  /**
+   * @return TSC ticks per millisecond (0 if not calibrated)
+   */
+  uint32_t tsc_khz();
+
+  /**
+   * @param ticks   A number of TSC ticks
+   * @return The ticks in nanoseconds (0 if not calibrated)
+   */
+  uint64_t to_ns(uint64_t ticks);
+
+  /**
+   * @return Nanoseconds since calibration
+   */
+  uint64_t now();
+}
+
+APEX_END
@@ -0,0 +1,230 @@
+#pragma once
+
+/* APEX */
+#include "libapex"
+
+/* Compiler */
+#include <stdint.h>
+
+APEX_BEGIN
+
+/**
+ * @class handler_chain
+ * @brief A priority-ordered list of handlers, readable from any context without locks
+ *
+ * Readers (i.e. interrupt handlers) get an immutable snapshot, which is
+ *   a single atomic load, and walk it as a flat array.
+ *
+ * Writers (add/remove) copy the current snapshot, change the copy, and
+ *   publish it with one atomic store -- RCU style. The old snapshot is
+ *   retired rather than reused, since a reader might still be walking it;
+ *   reclaim() frees retired snapshots once no reader can hold one
+ *   (i.e. from the idle loop, or after the dispatch that read them).
+ *
+ * Snapshots come from a fixed pool in the chain, so nothing allocates.
+ *   A change fails if every snapshot is current or retired (call reclaim()).
+ *
+ * Writers must be serialized with each other, and can't run in interrupt context.
+ *
+ * @tparam Handler    The handler type (usually a function pointer), must be ==-comparable
+ * @tparam N          The most handlers in one chain
+ * @tparam Snapshots  The pool size -- the current snapshot, plus the changes allowed between reclaims
+ */
+template<typename Handler, uint32_t N = 8, uint32_t Snapshots = 4>
+class handler_chain
+{
+  static_assert(Snapshots >= 2, "handler_chain needs a snapshot to copy into");
+
+public:
+  /* A single handler */
+  struct entry
+  {
+    Handler handler;
+    int priority;
+  };
+
+  /* An immutable, published set of handlers, highest priority first */
+  class snapshot
+  {
+    friend class handler_chain;
+  public:
+    entry const* begin() const
+    { return entries; }
+    entry const* end() const
+    { return entries + count; }
+
+    uint32_t size() const
+    { return count; }
+
+  private:
+    uint32_t count;
+    entry entries[N];
+  };
+
+  /* Constructs an empty chain */
+  constexpr handler_chain()
+  :current(nullptr)
+  ,pool()
+  ,state()
+  { }
+
+  /* NOT COPYABLE -- readers hold pointers into the chain */
+  handler_chain(handler_chain const&)             = delete;
+  handler_chain& operator=(handler_chain const&)  = delete;
+
+  /**
+   * Reader side
+   * @return The current snapshot, nullptr if the chain is empty
+   */
+  snapshot const* read() const
+  { return __atomic_load_n(&current, __ATOMIC_ACQUIRE); }
+
+  bool empty() const
+  { return read() == nullptr; }
+
+  /**
+   * Adds a handler after any others of the same priority
+   *
+   * @param handler   The handler to add
+   * @param priority  Higher priorities run first
+   * @return False if the chain is full, or no snapshot is free
+   */
+  bool add(Handler handler, int priority = 0)
+  {
+    snapshot const* old = current;
+    if(old && old->count == N)
+      return false;
+
+    snapshot* next = take();
+    if(!next)
+      return false;
+
+    uint32_t i = 0;
+    for(; old && i < old->count && old->entries[i].priority >= priority; ++i)
+      next->entries[next->count++] = old->entries[i];
+
+    next->entries[next->count++] = {handler, priority};
+
+    for(; old && i < old->count; ++i)
+      next->entries[next->count++] = old->entries[i];
+
+    publish(next);
+    return true;
+  }
+
+  /**
+   * Removes the first occurrence of a handler
+   *
+   * @param handler   The handler to remove
+   * @return False if it wasn't in the chain, or no snapshot is free
+   */
+  bool remove(Handler handler)
+  {
+    snapshot const* old = current;
+    if(!old)
+      return false;
+
+    snapshot* next = take();
+    if(!next)
+      return false;
+
+    bool found = false;
+    for(uint32_t i = 0; i < old->count; ++i)
+    {
+      if(!found && old->entries[i].handler == handler)
+        found = true;
+      else
+        next->entries[next->count++] = old->entries[i];
+    }
+
+    if(!found)
+    {
+      give_back(next);
+      return false;
+    }
+
+    /* The empty chain is nullptr */
+    if(!next->count)
+    {
+      give_back(next);
+      next = nullptr;
+    }
+
+    publish(next);
+    return true;
+  }
+
+  /**
+   * Removes every handler
+   */
+  void clear()
+  { publish(nullptr); }
+
+  /**
+   * Frees retired snapshots
+   * Only call when no reader can still be walking one
+   */
+  void reclaim()
+  {
+    for(slot_state& st : state)
+      if(st == RETIRED)
+        st = FREE;
+  }
+
+  /**
+   * @return True if there are snapshots waiting for reclaim()
+   */
+  bool has_retired() const
+  {
+    for(slot_state st : state)
+      if(st == RETIRED)
+        return true;
+    return false;
+  }
+
+private:
+  /* What each pool snapshot holds */
+  enum slot_state : uint8_t
+  {
+    FREE = 0,
+    IN_USE,   /* current, or being built */
+    RETIRED,
+  };
+
+  /* Takes an empty snapshot from the pool, nullptr if none are free */
+  snapshot* take()
+  {
+    for(uint32_t i = 0; i < Snapshots; ++i)
+      if(state[i] == FREE)
+      {
+        state[i] = IN_USE;
+        pool[i].count = 0;
+        return &pool[i];
+      }
+
+    return nullptr;
+  }
+
+  /* Returns a snapshot that was never published */
+  void give_back(snapshot* s)
+  { state[s - pool] = FREE; }
+
+  /* Swaps in a new snapshot, and retires the old one */
+  void publish(snapshot* next)
+  {
+    snapshot* old = current;
+    __atomic_store_n(&current, next, __ATOMIC_RELEASE);
+
+    if(old)
+      state[old - pool] = RETIRED;
+  }
+
+  /* The published snapshot */
+  snapshot* current;
+
+  /* The snapshots, and what each one holds */
+  snapshot pool[Snapshots];
+  slot_state state[Snapshots];
+};
+
+APEX_END
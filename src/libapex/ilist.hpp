@@ -0,0 +1,393 @@
+#pragma once
+
+/* APEX */
+#include "libapex"
+
+/* STL */
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Intrusive linked lists
+ *
+ * The link (hook) lives inside the object, so linking/unlinking never allocates.
+ * An object joins a list by deriving from the hook for that list's tag:
+ *
+ *   struct timer : apex::ilist_hook<>, apex::ilist_hook<run_queue_tag> { ... };
+ *   apex::ilist<timer> timers;
+ *   apex::ilist<timer, run_queue_tag> run_queue;
+ *
+ * The lists never own their elements -- the caller manages object lifetime,
+ *   and must unlink an object before destroying it.
+ */
+
+APEX_BEGIN
+
+/**
+ * @struct ilist_hook
+ * @brief The links for an object in an apex::ilist
+ *
+ * @tparam Tag    Distinguishes hooks when an object is in several lists
+ */
+template<typename Tag = void>
+struct ilist_hook
+{
+  constexpr ilist_hook()
+  :prev(nullptr)
+  ,next(nullptr)
+  { }
+
+  /* Copying an object never copies its membership */
+  constexpr ilist_hook(ilist_hook const&)
+  :ilist_hook()
+  { }
+  ilist_hook& operator=(ilist_hook const&)
+  { return *this; }
+
+  /* True if this object is currently in a list */
+  bool is_linked() const
+  { return next != nullptr; }
+
+  /* Removes this object from whatever list it's in (O(1)) */
+  void unlink()
+  {
+    prev->next = next;
+    next->prev = prev;
+    prev = next = nullptr;
+  }
+
+  ilist_hook* prev;
+  ilist_hook* next;
+};
+
+/**
+ * @class ilist
+ * @brief A circular, doubly-linked intrusive list
+ *
+ * All operations except size() and clear() are O(1)
+ *
+ * @tparam T      The element type (must derive from ilist_hook<Tag>)
+ * @tparam Tag    Which of T's hooks to use
+ */
+template<typename T, typename Tag = void>
+class ilist
+{
+  static_assert(std::is_class<T>::value, "apex::ilist elements must be classes deriving from apex::ilist_hook");
+
+  using hook = ilist_hook<Tag>;
+
+  /* Converts between hooks and elements */
+  static T* to_elem(hook* h)
+  { return static_cast<T*>(h); }
+  static hook* to_hook(T* t)
+  { return static_cast<hook*>(t); }
+
+  /* Iterator for both const and non-const lists */
+  template<bool is_const>
+  class iterator_t
+  {
+    friend class ilist;
+    using hook_ptr = typename std::conditional<is_const, hook const*, hook*>::type;
+  public:
+    using value_type = T;
+    using reference = typename std::conditional<is_const, T const&, T&>::type;
+    using pointer = typename std::conditional<is_const, T const*, T*>::type;
+
+    iterator_t(hook_ptr _h)
+    :h(_h)
+    { }
+
+    /* Conversion from non-const to const */
+    operator iterator_t<true>() const
+    { return iterator_t<true>(h); }
+
+    reference operator*() const
+    { return *static_cast<pointer>(h); }
+    pointer operator->() const
+    { return static_cast<pointer>(h); }
+
+    iterator_t& operator++()
+    {
+      h = h->next;
+      return *this;
+    }
+    iterator_t operator++(int)
+    {
+      iterator_t prev = *this;
+      h = h->next;
+      return prev;
+    }
+
+    iterator_t& operator--()
+    {
+      h = h->prev;
+      return *this;
+    }
+    iterator_t operator--(int)
+    {
+      iterator_t prev = *this;
+      h = h->prev;
+      return prev;
+    }
+
+    bool operator==(iterator_t const& other) const
+    { return h == other.h; }
+    bool operator!=(iterator_t const& other) const
+    { return h != other.h; }
+
+  private:
+    hook_ptr h;
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T&;
+  using const_reference = T const&;
+  using iterator = iterator_t<false>;
+  using const_iterator = iterator_t<true>;
+
+  /* Constructs an empty list */
+  ilist()
+  { root.prev = root.next = &root; }
+
+  /* NOT COPYABLE -- elements can only be in one list per hook */
+  ilist(ilist const&)             = delete;
+  ilist& operator=(ilist const&)  = delete;
+
+  /* Destructor -- unlinks (but doesn't destroy) all elements */
+  ~ilist()
+  { clear(); }
+
+  /**
+   * Element access
+   * UB on an empty list
+   */
+  reference front()
+  { return *to_elem(root.next); }
+  const_reference front() const
+  { return *static_cast<T const*>(root.next); }
+
+  reference back()
+  { return *to_elem(root.prev); }
+  const_reference back() const
+  { return *static_cast<T const*>(root.prev); }
+
+  /**
+   * Iterators
+   */
+  iterator begin()
+  { return iterator(root.next); }
+  const_iterator begin() const
+  { return const_iterator(root.next); }
+  const_iterator cbegin() const
+  { return begin(); }
+
+  iterator end()
+  { return iterator(&root); }
+  const_iterator end() const
+  { return const_iterator(&root); }
+  const_iterator cend() const
+  { return end(); }
+
+  /* Iterator to a linked element */
+  static iterator iterator_to(T& t)
+  { return iterator(to_hook(&t)); }
+
+  /**
+   * Capacity
+   */
+  bool empty() const
+  { return root.next == &root; }
+
+  /* O(n) -- walks the list */
+  size_type size() const
+  {
+    size_type s = 0;
+    for(hook const* h = root.next; h != &root; h = h->next)
+      ++s;
+    return s;
+  }
+
+  /**
+   * Modifiers
+   */
+
+  /* Links t before pos, returns an iterator to t */
+  iterator insert(const_iterator pos, T& t)
+  {
+    hook* next = const_cast<hook*>(pos.h);
+    hook* h = to_hook(&t);
+
+    h->next = next;
+    h->prev = next->prev;
+    next->prev->next = h;
+    next->prev = h;
+
+    return iterator(h);
+  }
+
+  void push_front(T& t)
+  { insert(begin(), t); }
+
+  void push_back(T& t)
+  { insert(end(), t); }
+
+  /* Unlinks the element at pos, returns the element after it */
+  iterator erase(const_iterator pos)
+  {
+    hook* h = const_cast<hook*>(pos.h);
+    hook* next = h->next;
+    h->unlink();
+    return iterator(next);
+  }
+
+  /* Unlinks t, which must be in this list */
+  void erase(T& t)
+  { to_hook(&t)->unlink(); }
+
+  /* Unlinks and returns the first element (UB if empty) */
+  T& pop_front()
+  {
+    T& t = front();
+    erase(t);
+    return t;
+  }
+
+  /* Unlinks and returns the last element (UB if empty) */
+  T& pop_back()
+  {
+    T& t = back();
+    erase(t);
+    return t;
+  }
+
+  /* Unlinks every element */
+  void clear()
+  {
+    while(!empty())
+      root.next->unlink();
+  }
+
+  /* Moves all of other's elements before pos (O(1)) */
+  void splice(const_iterator pos, ilist& other)
+  {
+    if(other.empty())
+      return;
+
+    hook* next = const_cast<hook*>(pos.h);
+    hook* first = other.root.next;
+    hook* last = other.root.prev;
+
+    first->prev = next->prev;
+    next->prev->next = first;
+    last->next = next;
+    next->prev = last;
+
+    other.root.prev = other.root.next = &other.root;
+  }
+
+  /* Exchanges the contents of two lists (O(1)) */
+  void swap(ilist& other)
+  {
+    ilist temp;
+    temp.splice(temp.end(), other);
+    other.splice(other.end(), *this);
+    splice(end(), temp);
+  }
+
+private:
+  /* Sentinel -- root.next is the front, root.prev is the back */
+  hook root;
+};
+
+/**
+ * @struct islist_hook
+ * @brief The link for an object in an apex::islist
+ */
+template<typename Tag = void>
+struct islist_hook
+{
+  constexpr islist_hook()
+  :next(nullptr)
+  { }
+
+  /* Copying an object never copies its membership */
+  constexpr islist_hook(islist_hook const&)
+  :islist_hook()
+  { }
+  islist_hook& operator=(islist_hook const&)
+  { return *this; }
+
+  islist_hook* next;
+};
+
+/**
+ * @class islist
+ * @brief A singly-linked intrusive stack (LIFO), i.e. for free lists
+ *
+ * @tparam T      The element type (must derive from islist_hook<Tag>)
+ * @tparam Tag    Which of T's hooks to use
+ */
+template<typename T, typename Tag = void>
+class islist
+{
+  static_assert(std::is_class<T>::value, "apex::islist elements must be classes deriving from apex::islist_hook");
+
+  using hook = islist_hook<Tag>;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  constexpr islist()
+  :head(nullptr)
+  { }
+
+  /* NOT COPYABLE -- elements can only be in one list per hook */
+  islist(islist const&)             = delete;
+  islist& operator=(islist const&)  = delete;
+
+  bool empty() const
+  { return head == nullptr; }
+
+  /* The top element (UB if empty) */
+  T& front()
+  { return *static_cast<T*>(head); }
+
+  void push_front(T& t)
+  {
+    hook* h = static_cast<hook*>(&t);
+    h->next = head;
+    head = h;
+  }
+
+  /* Unlinks and returns the top element (nullptr if empty) */
+  T* pop_front()
+  {
+    if(!head)
+      return nullptr;
+
+    hook* h = head;
+    head = h->next;
+    h->next = nullptr;
+    return static_cast<T*>(h);
+  }
+
+  /* Unlinks every element */
+  void clear()
+  {
+    while(pop_front())
+      ;
+  }
+
+  /* Exchanges the contents of two lists */
+  void swap(islist& other)
+  { std::swap(head, other.head); }
+
+private:
+  hook* head;
+};
+
+APEX_END
@@ -0,0 +1,136 @@
+#pragma once
+
+/* APEX */
+#include "libapex"
+
+/* Compiler */
+#include <stdint.h>
+
+APEX_BEGIN
+
+/**
+ * @class mpsc_ring
+ * @brief A fixed-capacity, lock-free, multi-producer/single-consumer queue
+ *
+ * Any number of contexts may push (i.e. the main loop, and interrupt handlers
+ * that interrupt it half-way through a push), and exactly one context may pop.
+ *
+ * - N must be a power of two, so wrapping an index is a single mask
+ * - Producers claim a slot by advancing tail with a compare-and-swap,
+ *   then publish it through the slot's sequence number
+ * - The constructor is constexpr (an empty ring is all zeros), so a global ring
+ *   can be pushed to before static constructors run
+ * - A producer never waits on another, a full ring drops the element
+ * - The consumer stops at the first claimed but unpublished slot,
+ *   an interrupted producer's element (and those after it) is popped once it finishes
+ * - T must be default-constructible and copy-assignable
+ */
+template<typename T, uint32_t N>
+class mpsc_ring
+{
+  static_assert(N > 1 && !(N & (N - 1)), "mpsc_ring capacity must be a power of two (and at least 2)");
+
+public:
+  /* Constructs an empty ring */
+  constexpr mpsc_ring()
+  :head(0)
+  ,tail(0)
+  ,slots{}
+  { }
+
+  /* NOT COPYABLE -- the indices are shared between contexts */
+  mpsc_ring(mpsc_ring const&)             = delete;
+  mpsc_ring& operator=(mpsc_ring const&)  = delete;
+
+  /**
+   * Producer side -- appends a copy of val
+   *
+   * @param val   The element to enqueue
+   * @return      false if the ring was full (val is dropped)
+   */
+  bool push(T const& val)
+  {
+    uint32_t t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+    for(;;)
+    {
+      slot& s = slots[t & mask];
+      uint32_t lap = t & ~mask;
+      uint32_t seq = __atomic_load_n(&s.sequence, __ATOMIC_ACQUIRE);
+
+      if(seq != lap)
+      {
+        /* Still holds the element from N pushes ago */
+        if(static_cast<int32_t>(seq - lap) < 0)
+          return false;
+
+        /* Another producer got here first */
+        t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+        continue;
+      }
+
+      if(__atomic_compare_exchange_n(&tail, &t, t + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      {
+        s.value = val;
+        __atomic_store_n(&s.sequence, lap + 1, __ATOMIC_RELEASE);
+        return true;
+      }
+    }
+  }
+
+  /**
+   * Consumer side -- removes the oldest element
+   *
+   * @param out   Receives the dequeued element
+   * @return      false if the ring was empty, or the oldest element isn't published yet
+   */
+  bool pop(T& out)
+  {
+    slot& s = slots[head & mask];
+    uint32_t lap = head & ~mask;
+    if(__atomic_load_n(&s.sequence, __ATOMIC_ACQUIRE) != lap + 1)
+      return false;
+
+    out = s.value;
+
+    /* Free for the push N later */
+    __atomic_store_n(&s.sequence, lap + N, __ATOMIC_RELEASE);
+    ++head;
+    return true;
+  }
+
+  /**
+   * Capacity -- a snapshot (including claimed but unpublished slots)
+   */
+  uint32_t size() const
+  { return __atomic_load_n(&tail, __ATOMIC_ACQUIRE) - head; }
+
+  bool empty() const
+  { return size() == 0; }
+
+  static constexpr uint32_t capacity()
+  { return N; }
+
+private:
+  /* Mask used to wrap the free-running indices */
+  static constexpr uint32_t mask = N - 1;
+
+  /*
+   * An element, and its sequence -- for the pushes of a lap (the index with the slot bits cleared),
+   * lap when the slot is free, lap + 1 once the element is published
+   */
+  struct slot
+  {
+    uint32_t sequence;
+    T value;
+  };
+
+  /* Next element to pop (consumer only) */
+  uint32_t head;
+  /* Next slot to claim (shared by the producers) */
+  uint32_t tail;
+
+  /* The element storage */
+  slot slots[N];
+};
+
+APEX_END
@@ -0,0 +1,618 @@
+#pragma once
+
+/* APEX */
+#include "libapex"
+
+/* STL */
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Intrusive red-black tree
+ *
+ * Like apex::ilist, the node lives inside the object, so insert/erase never allocate:
+ *
+ *   struct vma : apex::rbtree_hook<> { uintptr_t base; ... };
+ *   struct vma_less { bool operator()(vma const& l, vma const& r) const { return l.base < r.base; } };
+ *   apex::rbtree<vma, vma_less> vmas;
+ *
+ * Equal keys are allowed, and keep their insertion order.
+ * The tree never owns its elements -- erase an object before destroying it.
+ */
+
+APEX_BEGIN
+
+/**
+ * @struct rbtree_hook
+ * @brief The node for an object in an apex::rbtree
+ *
+ * @tparam Tag    Distinguishes hooks when an object is in several trees
+ */
+template<typename Tag = void>
+struct rbtree_hook
+{
+  constexpr rbtree_hook()
+  :parent(nullptr)
+  ,left(nullptr)
+  ,right(nullptr)
+  ,red(false)
+  { }
+
+  /* Copying an object never copies its membership */
+  constexpr rbtree_hook(rbtree_hook const&)
+  :rbtree_hook()
+  { }
+  rbtree_hook& operator=(rbtree_hook const&)
+  { return *this; }
+
+  /* Left-most node of the subtree rooted here */
+  rbtree_hook* minimum()
+  {
+    rbtree_hook* n = this;
+    while(n->left)
+      n = n->left;
+    return n;
+  }
+
+  /* Right-most node of the subtree rooted here */
+  rbtree_hook* maximum()
+  {
+    rbtree_hook* n = this;
+    while(n->right)
+      n = n->right;
+    return n;
+  }
+
+  /* In-order successor (nullptr if this is the last node) */
+  rbtree_hook* successor()
+  {
+    if(right)
+      return right->minimum();
+
+    rbtree_hook* n = this;
+    rbtree_hook* p = parent;
+    while(p && n == p->right)
+    {
+      n = p;
+      p = p->parent;
+    }
+    return p;
+  }
+
+  /* In-order predecessor (nullptr if this is the first node) */
+  rbtree_hook* predecessor()
+  {
+    if(left)
+      return left->maximum();
+
+    rbtree_hook* n = this;
+    rbtree_hook* p = parent;
+    while(p && n == p->left)
+    {
+      n = p;
+      p = p->parent;
+    }
+    return p;
+  }
+
+  rbtree_hook* parent;
+  rbtree_hook* left;
+  rbtree_hook* right;
+  bool red;
+};
+
+/* The default comparison, only using < */
+namespace detail
+{
+  struct rbtree_less
+  {
+    template<typename T1, typename T2>
+    bool operator()(T1 const& lhs, T2 const& rhs) const
+    { return lhs < rhs; }
+  };
+}
+
+/**
+ * @class rbtree
+ * @brief An intrusive, ordered red-black tree
+ *
+ * insert/erase/find are O(log n), iteration is in order of Compare
+ *
+ * @tparam T        The element type (must derive from rbtree_hook<Tag>)
+ * @tparam Compare  Strict-weak ordering; find/lower_bound/upper_bound with a
+ *                  key K additionally need Compare(T,K) and Compare(K,T)
+ * @tparam Tag      Which of T's hooks to use
+ */
+template<typename T, typename Compare = detail::rbtree_less, typename Tag = void>
+class rbtree
+{
+  static_assert(std::is_class<T>::value, "apex::rbtree elements must be classes deriving from apex::rbtree_hook");
+
+  using hook = rbtree_hook<Tag>;
+
+  /* Converts between hooks and elements */
+  static T* to_elem(hook* h)
+  { return static_cast<T*>(h); }
+  static hook* to_hook(T* t)
+  { return static_cast<hook*>(t); }
+
+  /* Bidirectional in-order iterator, end() is nullptr */
+  template<bool is_const>
+  class iterator_t
+  {
+    friend class rbtree;
+  public:
+    using value_type = T;
+    using reference = typename std::conditional<is_const, T const&, T&>::type;
+    using pointer = typename std::conditional<is_const, T const*, T*>::type;
+
+    iterator_t(hook* _h, rbtree const* _tree)
+    :h(_h)
+    ,tree(_tree)
+    { }
+
+    /* Conversion from non-const to const */
+    operator iterator_t<true>() const
+    { return iterator_t<true>(h, tree); }
+
+    reference operator*() const
+    { return *static_cast<pointer>(h); }
+    pointer operator->() const
+    { return static_cast<pointer>(h); }
+
+    iterator_t& operator++()
+    {
+      h = h->successor();
+      return *this;
+    }
+    iterator_t operator++(int)
+    {
+      iterator_t prev = *this;
+      ++*this;
+      return prev;
+    }
+
+    /* Decrementing end() yields the last element */
+    iterator_t& operator--()
+    {
+      h = h ? h->predecessor() : tree->root->maximum();
+      return *this;
+    }
+    iterator_t operator--(int)
+    {
+      iterator_t prev = *this;
+      --*this;
+      return prev;
+    }
+
+    bool operator==(iterator_t const& other) const
+    { return h == other.h; }
+    bool operator!=(iterator_t const& other) const
+    { return h != other.h; }
+
+  private:
+    hook* h;
+    rbtree const* tree;
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T&;
+  using const_reference = T const&;
+  using iterator = iterator_t<false>;
+  using const_iterator = iterator_t<true>;
+
+  /* Constructs an empty tree */
+  rbtree(Compare _comp = Compare())
+  :root(nullptr)
+  ,count(0)
+  ,comp(_comp)
+  { }
+
+  /* NOT COPYABLE -- elements can only be in one tree per hook */
+  rbtree(rbtree const&)             = delete;
+  rbtree& operator=(rbtree const&)  = delete;
+
+  /* Destructor -- unlinks (but doesn't destroy) all elements */
+  ~rbtree()
+  { clear(); }
+
+  /**
+   * Iterators
+   */
+  iterator begin()
+  { return iterator(root ? root->minimum() : nullptr, this); }
+  const_iterator begin() const
+  { return const_iterator(root ? root->minimum() : nullptr, this); }
+
+  iterator end()
+  { return iterator(nullptr, this); }
+  const_iterator end() const
+  { return const_iterator(nullptr, this); }
+
+  /* Iterator to a linked element */
+  iterator iterator_to(T& t)
+  { return iterator(to_hook(&t), this); }
+
+  /**
+   * Capacity
+   */
+  bool empty() const
+  { return root == nullptr; }
+
+  size_type size() const
+  { return count; }
+
+  /**
+   * Lookup
+   */
+
+  /* First element not less than key */
+  template<typename K>
+  iterator lower_bound(K const& key)
+  {
+    hook* result = nullptr;
+    for(hook* n = root; n; )
+    {
+      if(comp(*to_elem(n), key))
+        n = n->right;
+      else
+      {
+        result = n;
+        n = n->left;
+      }
+    }
+    return iterator(result, this);
+  }
+
+  /* First element greater than key */
+  template<typename K>
+  iterator upper_bound(K const& key)
+  {
+    hook* result = nullptr;
+    for(hook* n = root; n; )
+    {
+      if(comp(key, *to_elem(n)))
+      {
+        result = n;
+        n = n->left;
+      }
+      else
+        n = n->right;
+    }
+    return iterator(result, this);
+  }
+
+  /* First element equivalent to key, or end() */
+  template<typename K>
+  iterator find(K const& key)
+  {
+    iterator it = lower_bound(key);
+    if(it != end() && comp(key, *it))
+      return end();
+    return it;
+  }
+
+  /**
+   * Modifiers
+   */
+
+  /* Links t into the tree (after any equivalent elements) */
+  iterator insert(T& t)
+  {
+    hook* n = to_hook(&t);
+    hook* parent = nullptr;
+    bool left = false;
+
+    for(hook* cur = root; cur; )
+    {
+      parent = cur;
+      left = comp(t, *to_elem(cur));
+      cur = left ? cur->left : cur->right;
+    }
+
+    n->parent = parent;
+    n->left = n->right = nullptr;
+    n->red = true;
+
+    if(!parent)
+      root = n;
+    else if(left)
+      parent->left = n;
+    else
+      parent->right = n;
+
+    insert_fixup(n);
+    ++count;
+    return iterator(n, this);
+  }
+
+  /* Unlinks the element at pos, returns the element after it */
+  iterator erase(const_iterator pos)
+  {
+    hook* next = pos.h->successor();
+    erase_node(pos.h);
+    return iterator(next, this);
+  }
+
+  /* Unlinks t, which must be in this tree */
+  void erase(T& t)
+  { erase_node(to_hook(&t)); }
+
+  /* Unlinks every element (O(n), without rebalancing) */
+  void clear()
+  {
+    hook* n = root;
+    while(n)
+    {
+      /* Descend to a leaf, then detach it from its parent */
+      if(n->left)
+        n = n->left;
+      else if(n->right)
+        n = n->right;
+      else
+      {
+        hook* parent = n->parent;
+        if(parent)
+          (parent->left == n ? parent->left : parent->right) = nullptr;
+
+        reset(n);
+        n = parent;
+      }
+    }
+
+    root = nullptr;
+    count = 0;
+  }
+
+  /* Exchanges the contents of two trees (O(1)) */
+  void swap(rbtree& other)
+  {
+    std::swap(root, other.root);
+    std::swap(count, other.count);
+    std::swap(comp, other.comp);
+  }
+
+private:
+  /* Clears a node's links (hook assignment deliberately doesn't copy them) */
+  static void reset(hook* n)
+  {
+    n->parent = n->left = n->right = nullptr;
+    n->red = false;
+  }
+
+  /* Rotates n's right child into n's place */
+  void rotate_left(hook* n)
+  {
+    hook* r = n->right;
+    n->right = r->left;
+    if(r->left)
+      r->left->parent = n;
+
+    replace_child(n, r);
+
+    r->left = n;
+    n->parent = r;
+  }
+
+  /* Rotates n's left child into n's place */
+  void rotate_right(hook* n)
+  {
+    hook* l = n->left;
+    n->left = l->right;
+    if(l->right)
+      l->right->parent = n;
+
+    replace_child(n, l);
+
+    l->right = n;
+    n->parent = l;
+  }
+
+  /* Points old's parent (or the root) at replacement */
+  void replace_child(hook* old, hook* replacement)
+  {
+    hook* parent = old->parent;
+    if(replacement)
+      replacement->parent = parent;
+
+    if(!parent)
+      root = replacement;
+    else if(parent->left == old)
+      parent->left = replacement;
+    else
+      parent->right = replacement;
+  }
+
+  /* Restores the red-black properties after linking the red node n */
+  void insert_fixup(hook* n)
+  {
+    while(n->parent && n->parent->red)
+    {
+      hook* parent = n->parent;
+      hook* grand = parent->parent;
+
+      if(parent == grand->left)
+      {
+        hook* uncle = grand->right;
+        if(uncle && uncle->red)
+        {
+          parent->red = uncle->red = false;
+          grand->red = true;
+          n = grand;
+          continue;
+        }
+
+        if(n == parent->right)
+        {
+          rotate_left(parent);
+          n = parent;
+          parent = n->parent;
+        }
+
+        parent->red = false;
+        grand->red = true;
+        rotate_right(grand);
+      }
+      else
+      {
+        hook* uncle = grand->left;
+        if(uncle && uncle->red)
+        {
+          parent->red = uncle->red = false;
+          grand->red = true;
+          n = grand;
+          continue;
+        }
+
+        if(n == parent->left)
+        {
+          rotate_right(parent);
+          n = parent;
+          parent = n->parent;
+        }
+
+        parent->red = false;
+        grand->red = true;
+        rotate_left(grand);
+      }
+    }
+
+    root->red = false;
+  }
+
+  /* Unlinks n and rebalances */
+  void erase_node(hook* n)
+  {
+    /* child replaces the removed position, parent is its (new) parent */
+    hook* child;
+    hook* parent;
+    bool removed_red;
+
+    if(!n->left || !n->right)
+    {
+      child = n->left ? n->left : n->right;
+      parent = n->parent;
+      removed_red = n->red;
+      replace_child(n, child);
+    }
+    else
+    {
+      /* Two children -- splice out the successor, then put it where n was */
+      hook* succ = n->right->minimum();
+      child = succ->right;
+      removed_red = succ->red;
+
+      if(succ->parent == n)
+        parent = succ;
+      else
+      {
+        parent = succ->parent;
+        replace_child(succ, child);
+        succ->right = n->right;
+        succ->right->parent = succ;
+      }
+
+      replace_child(n, succ);
+      succ->left = n->left;
+      succ->left->parent = succ;
+      succ->red = n->red;
+    }
+
+    if(!removed_red)
+      erase_fixup(child, parent);
+
+    reset(n);
+    --count;
+  }
+
+  /* Restores the red-black properties after removing a black node above n */
+  void erase_fixup(hook* n, hook* parent)
+  {
+    while(n != root && (!n || !n->red))
+    {
+      if(n == parent->left)
+      {
+        hook* sibling = parent->right;
+        if(sibling->red)
+        {
+          sibling->red = false;
+          parent->red = true;
+          rotate_left(parent);
+          sibling = parent->right;
+        }
+
+        if((!sibling->left || !sibling->left->red) &&
+           (!sibling->right || !sibling->right->red))
+        {
+          sibling->red = true;
+          n = parent;
+          parent = n->parent;
+          continue;
+        }
+
+        if(!sibling->right || !sibling->right->red)
+        {
+          sibling->left->red = false;
+          sibling->red = true;
+          rotate_right(sibling);
+          sibling = parent->right;
+        }
+
+        sibling->red = parent->red;
+        parent->red = false;
+        sibling->right->red = false;
+        rotate_left(parent);
+        n = root;
+      }
+      else
+      {
+        hook* sibling = parent->left;
+        if(sibling->red)
+        {
+          sibling->red = false;
+          parent->red = true;
+          rotate_right(parent);
+          sibling = parent->left;
+        }
+
+        if((!sibling->left || !sibling->left->red) &&
+           (!sibling->right || !sibling->right->red))
+        {
+          sibling->red = true;
+          n = parent;
+          parent = n->parent;
+          continue;
+        }
+
+        if(!sibling->left || !sibling->left->red)
+        {
+          sibling->right->red = false;
+          sibling->red = true;
+          rotate_left(sibling);
+          sibling = parent->left;
+        }
+
+        sibling->red = parent->red;
+        parent->red = false;
+        sibling->left->red = false;
+        rotate_right(parent);
+        n = root;
+      }
+    }
+
+    if(n)
+      n->red = false;
+  }
+
+  /* The root node (nullptr when empty) */
+  hook* root;
+  /* The number of linked elements */
+  size_type count;
+  /* The ordering */
+  Compare comp;
+};
+
+APEX_END
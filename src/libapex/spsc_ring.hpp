@@ -0,0 +1,116 @@
+#pragma once
+
+/* APEX */
+#include "libapex"
+
+/* Compiler */
+#include <stdint.h>
+
+APEX_BEGIN
+
+/**
+ * @class spsc_ring
+ * @brief A fixed-capacity, lock-free, single-producer/single-consumer queue
+ *
+ * Exactly one context may push (e.g. an interrupt handler) and exactly one
+ * other context may pop (e.g. the main loop), with no locking and without
+ * disabling interrupts.
+ *
+ * - N must be a power of two, so wrapping an index is a single mask
+ * - head/tail are free-running counters, so all N slots are usable
+ * - push publishes an element with release semantics,
+ *   pop observes it with acquire semantics
+ * - T must be default-constructible and copy-assignable
+ */
+template<typename T, uint32_t N>
+class spsc_ring
+{
+  static_assert(N && !(N & (N - 1)), "spsc_ring capacity must be a power of two");
+
+public:
+  /* Constructs an empty ring */
+  spsc_ring()
+  :head(0)
+  ,tail(0)
+  { }
+
+  /* NOT COPYABLE -- the indices are shared between two contexts */
+  spsc_ring(spsc_ring const&)             = delete;
+  spsc_ring& operator=(spsc_ring const&)  = delete;
+
+  /**
+   * Producer side -- appends a copy of val
+   *
+   * @param val   The element to enqueue
+   * @return      false if the ring was full (val is dropped)
+   */
+  bool push(T const& val)
+  {
+    uint32_t t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+    uint32_t h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    if(t - h == N)
+      return false;
+
+    buffer[t & mask] = val;
+    __atomic_store_n(&tail, t + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  /**
+   * Consumer side -- removes the oldest element
+   *
+   * @param out   Receives the dequeued element
+   * @return      false if the ring was empty (out is untouched)
+   */
+  bool pop(T& out)
+  {
+    uint32_t h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+    uint32_t t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+    if(h == t)
+      return false;
+
+    out = buffer[h & mask];
+    __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  /**
+   * Consumer side -- the oldest element, without removing it
+   * UB if the ring is empty
+   */
+  T const& front() const
+  { return buffer[__atomic_load_n(&head, __ATOMIC_RELAXED) & mask]; }
+
+  /**
+   * Capacity -- exact when called from either the producer or the consumer,
+   *   otherwise only a snapshot
+   */
+  uint32_t size() const
+  {
+    return __atomic_load_n(&tail, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+  }
+
+  bool empty() const
+  { return size() == 0; }
+
+  bool full() const
+  { return size() == N; }
+
+  static constexpr uint32_t capacity()
+  { return N; }
+
+private:
+  /* Mask used to wrap the free-running indices */
+  static constexpr uint32_t mask = N - 1;
+
+  /* Next element to pop (written by the consumer only) */
+  uint32_t head;
+  /* Next slot to push (written by the producer only) */
+  uint32_t tail;
+
+  /* The element storage */
+  T buffer[N];
+};
+
+APEX_END
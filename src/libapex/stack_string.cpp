@@ -14,6 +14,13 @@ stack_string::stack_string(const char* s /* = "" */)
     push_back(*(s++));
 }
 
+/* Initialize data to 0, then push the range back */
+stack_string::stack_string(const char* s, unsigned short count)
+  :stack_string()
+{
+  append(s, count);
+}
+
 /* Copy */
 stack_string::stack_string(const stack_string& other)
   :stack_string()
@@ -21,6 +28,19 @@ stack_string::stack_string(const stack_string& other)
   (*this) += other;
 }
 
+/* Assignment -- clears, so the characters stay null-terminated */
+stack_string& stack_string::operator=(const stack_string& other)
+{
+  if(this == &other)
+    return *this;
+
+  for(unsigned short s = 0; s < alloc_size; ++s)
+    data[s] = 0;
+  end = 0;
+
+  return (*this) += other;
+}
+
 /* Concatenation */
 stack_string& stack_string::operator+=(const stack_string& other)
 {
@@ -29,6 +49,14 @@ stack_string& stack_string::operator+=(const stack_string& other)
   return *this;
 }
 
+/* Range Concatenation */
+stack_string& stack_string::append(const char* s, unsigned short count)
+{
+  while(count--)
+    push_back(*(s++));
+  return *this;
+}
+
 /* UInt Concatenation */
 stack_string& stack_string::operator+=(uint32_t i)
 {
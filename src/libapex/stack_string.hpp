@@ -18,14 +18,34 @@ public:
   /* Default/Initial Constructor */
   stack_string(const char* = "");
 
+  /* Character range Constructor */
+  stack_string(const char* s, unsigned short count);
+
+  /* Construction from any string view (i.e. std::string_view, std::string) */
+  template<typename View, typename = decltype(static_cast<const char*>(static_cast<View const*>(nullptr)->data()))>
+  explicit stack_string(View const& view)
+  :stack_string(view.data(), view.size())
+  { }
+
   /* Copy Constructor */
   stack_string(const stack_string& other);
 
+  /* Copy Assignment */
+  stack_string& operator=(const stack_string& other);
+
   /* Concatenation */
   stack_string& operator+=(const stack_string& other);
   stack_string& operator+=(uint32_t i);
   stack_string& operator+=(void* p);
 
+  /* Concatenation of a character range */
+  stack_string& append(const char* s, unsigned short count);
+
+  /* Concatenation of any string view (i.e. std::string_view, std::string) */
+  template<typename View, typename = decltype(static_cast<const char*>(static_cast<View const*>(nullptr)->data()))>
+  stack_string& operator+=(View const& view)
+  { return append(view.data(), view.size()); }
+
   /* Operator+ For all += types */
   template<typename T>
   stack_string operator+(T other) const
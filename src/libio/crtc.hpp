@@ -0,0 +1,42 @@
+#pragma once
+
+/* Compiler */
+#include <stdint.h>
+
+namespace io
+{
+  /**
+   * The VGA CRT controller (color mode, ports 0x3D4/0x3D5)
+   *
+   * Offsets are in cells from the start of text VRAM (0xB8000),
+   * which holds vram_cells cells (32 KiB).
+   */
+  namespace crtc
+  {
+    /* The number of cells in text VRAM */
+    constexpr uint16_t vram_cells = 0x4000;
+
+    /**
+     * @brief Sets the cell the display starts at (the upper-left most character)
+     */
+    extern void set_start(uint16_t offset);
+
+    /**
+     * @brief Moves the hardware cursor to a cell
+     */
+    extern void set_cursor(uint16_t offset);
+
+    /**
+     * @brief Shows the hardware cursor as an underline covering the given scanlines
+     *
+     * @param first   The first scanline of the cursor (0-15)
+     * @param last    The last scanline of the cursor (0-15)
+     */
+    extern void show_cursor(uint8_t first = 14, uint8_t last = 15);
+
+    /**
+     * @brief Hides the hardware cursor
+     */
+    extern void hide_cursor();
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+/* Compiler */
+#include <stdint.h>
+
+namespace io
+{
+  /**
+   * A built-in 8x8 bitmap font for drawing text on a framebuffer
+   *
+   * Covers printable ASCII, plus the code page 437 box drawing and
+   * shade characters the screens use (everything else is blank).
+   * Each glyph is 8 rows, top first, the most significant bit is the leftmost pixel.
+   */
+  namespace font
+  {
+    constexpr unsigned int width = 8;
+    constexpr unsigned int height = 8;
+
+    extern uint8_t const glyphs[256][height];
+  }
+}
@@ -2,7 +2,6 @@
 
 /* STL */
 #include <array>
-#include <vector>
 
 namespace io
 {
@@ -41,6 +40,19 @@ namespace io
       KEY_LSHIFT, KEY_RSHIFT,
       KEY_LCTRL, KEY_RCTRL,
       KEY_LALT, KEY_RALT,
+
+      /* Whitespace and editing */
+      KEY_ESCAPE, KEY_BACKSPACE, KEY_TAB, KEY_ENTER, KEY_SPACE,
+
+      /* Punctuation */
+      KEY_MINUS, KEY_EQUALS, KEY_LBRACKET, KEY_RBRACKET,
+      KEY_SEMICOLON, KEY_APOSTROPHE, KEY_GRAVE, KEY_BACKSLASH,
+      KEY_COMMA, KEY_PERIOD, KEY_SLASH,
+
+      /* Navigation (0xE0-prefixed) */
+      KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT,
+      KEY_HOME, KEY_END, KEY_PAGE_UP, KEY_PAGE_DOWN,
+      KEY_INSERT, KEY_DELETE,
     };
 
     /**
@@ -72,7 +84,7 @@ namespace io
       char ascii;
       /** @brief The enumeration for the key */
       key_t key;
-      /** @brief Any modifiers present */
+      /** @brief Any modifiers held (unused slots are KEY_NULL) */
       std::array<key_t, 6> modifiers;
       /** @brief The type of event this is */
       type type;
@@ -82,9 +94,12 @@ namespace io
     using event_callback = void(*)(event_t const&);
 
     /**
-     * @param f     The function to call when events are recieved
+     * Callbacks run in the keyboard's bottom half, and may (de)register callbacks
+     *
+     * @param f         The function to call when events are recieved
+     * @param priority  Higher priorities are called first
      */
-    extern void register_callback(event_callback f);
+    extern void register_callback(event_callback f, int priority = 0);
 
     /**
      * @param f     The function to stop calling
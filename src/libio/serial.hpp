@@ -0,0 +1,55 @@
+#pragma once
+
+/* STL */
+#include <string_view>
+
+namespace io
+{
+  /**
+   * COM1, a 16550 UART
+   *
+   * Output goes through a transmit ring, which the IRQ4 handler feeds to the
+   *   UART a FIFO (16 bytes) at a time, so write() only waits when the ring is full.
+   * Until enable() (or with interrupts disabled, i.e. crash dumps from an exception handler)
+   *   write() flushes the ring, then sends polled.
+   *
+   * The ring has a single producer, so write() shouldn't be called from an ISR
+   *   while another context is writing (log through klog instead).
+   */
+  namespace serial
+  {
+    /* The size of the transmit ring */
+    constexpr unsigned int tx_size = 4096;
+
+    /**
+     * @brief Initializes COM1 (115200 baud, 8N1, FIFOs enabled) for polled output
+     */
+    extern void initialize();
+
+    /**
+     * @brief Installs the IRQ4 handler, and switches to interrupt-driven output
+     * Requires irq::initialize()
+     */
+    extern void enable();
+
+    /**
+     * @brief Switches back to polled output (flushing the ring), and removes the IRQ4 handler
+     */
+    extern void disable();
+
+    /**
+     * @brief Writes a single character, waiting until the UART can take it (bypasses the ring)
+     */
+    extern void put(char c);
+
+    /**
+     * @brief Writes a string, translating '\n' to "\r\n"
+     */
+    extern void write(std::string_view str);
+
+    /**
+     * @brief Sends everything in the transmit ring, polled
+     */
+    extern void flush();
+  }
+}
@@ -1,26 +1,84 @@
 #include "vga_screen"
 
+#include "crtc"
 #include "keyboard"
 
+/* STL */
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 namespace io
 {
   namespace screen
   {
+    /*
+     * Border palettes (code page 437)
+     * [0] = Upper-left
+     * [1] = Upper-right
+     * [2] = Lower-left
+     * [3] = Lower-right
+     * [4] = Horizontal bar
+     * [5] = Vertical bar
+     */
+    static constexpr std::array<char, 6> active_palette =
+      {char(201), char(187), char(200), char(188), char(205), char(186)};
+    static constexpr std::array<char, 6> inactive_palette =
+      {char(218), char(191), char(192), char(217), char(196), char(179)};
+
+    /* Text VRAM */
+    static cell_t* const vram_base = reinterpret_cast<cell_t*>(0xb8000);
+
+    /* A row with no changed cells */
+    static constexpr unsigned short clean_first = 0xffff;
+    static constexpr unsigned short clean_last = 0;
+
+    /* Aligns, then fills with rep stosl */
+    void fill_cells(cell_t* dst, cell_t value, std::size_t count)
+    {
+      if(count && (reinterpret_cast<uintptr_t>(dst) & 2))
+      {
+        *dst++ = value;
+        --count;
+      }
+
+      uint32_t pair = value | (static_cast<uint32_t>(value) << 16);
+      std::size_t pairs = count / 2;
+      asm volatile("rep stosl"
+                   : "+D"(dst), "+c"(pairs)
+                   : "a"(pair)
+                   : "memory");
+
+      if(count & 1)
+        *dst = value;
+    }
+
     /**
      * vga_screen definition
      */
 
     /* Constructs a windows with a border! */
-    vga_screen::vga_screen(coord const& _origin, coord const& _size, std::string const& _title, vga_manager* _manager)
+    vga_screen::vga_screen(coord const& _origin, coord const& _size, std::string_view _title, vga_manager* _manager)
       :has_border(false)
       ,active(false)
+      ,any_dirty(false)
+      ,border_dirty(false)
+      ,occluded(true)
       ,origin(_origin)
       ,size(_size)
       ,manager(_manager)
       ,title(_title)
       ,cursor_stack({{0,0}})
       ,attrib_stack({{color::LIGHT_GRAY, color::BLACK}})
-      ,framebuffer(size.y, std::vector<vga_entry>(size.x, {' ', {color::LIGHT_GRAY, color::BLACK}}))
+      ,saved_cursor(0,0)
+      ,bold(false)
+      ,head(0)
+      ,scrolled(0)
+      ,history_lines(0)
+      ,history_head(0)
+      ,history_count(0)
+      ,view_offset(0)
+      ,view_dirty(false)
     {
       /* Validate size */
       if(size.x > 2 && size.y > 2)
@@ -29,133 +87,298 @@ namespace io
         size -= coord{2,2};
         has_border = true;
       }
+
+      framebuffer.resize(size.x * size.y, make_cell(' ', peek_attrib()));
+      for(unsigned short y = 0; y < size.y; ++y)
+        rows.push_back(framebuffer.data() + y * size.x);
+
+      if(has_border)
+        border_line.resize(size.x + 2);
+
+      dirty.resize(size.y, {clean_first, clean_last});
     }
 
-    /* Write a c-style string */
-    vga_screen& vga_screen::write(char const* str)
+    /* Write a range of characters */
+    vga_screen& vga_screen::write(std::string_view str)
     {
-      for(; *str; ++str)
-        put(*str);
+      for(char c : str)
+        put(c);
 
-      manager->passive_update_all();
+      manager->present();
 
       return *this;
     }
 
-    /* Write a c++ style string */
-    vga_screen& vga_screen::write(std::string const& str)
-    { return write(str.c_str()); }
-
     /* Re-draw the border */
     void vga_screen::update_border()
     {
       if(!has_border)
         return;
 
-      /* The border's origin */
-      coord border_origin = origin - coord{1,1};
+      border_dirty = false;
 
       attrib_t attrib = active ? manager->get_active_border()
                                : manager->get_inactive_border();
 
-      /* Helper function to plot a single character on the border */
-      auto put = [this, &border_origin, &attrib](char c, unsigned short x, unsigned short y)
-      {
-        vram_addr(border_origin + coord{x,y})[0] = c;
-        vram_addr(border_origin + coord{x,y})[1] = attrib;
-      };
+      /* The characters to draw with (see active_palette and inactive_palette) */
+      std::array<char, 6> const& palette = active ? active_palette : inactive_palette;
 
-      /*
-       * The characters to draw with
-       * [0] = Upper-left
-       * [1] = Upper-right
-       * [2] = Lower-left
-       * [3] = Lower-right
-       * [4] = Horizontal bar
-       * [5] = Vertical bar
-       */
-      char palette[6];
-      if(active)
+      /* Each edge is built as a line of cells, then blit */
+      coord border_origin = origin - coord{1,1};
+      unsigned short width = size.x + 2;
+      cell_t* line = border_line.data();
+      fill_cells(line, make_cell(palette[4], attrib), width);
+
+      /* Top Row, with the title */
+      line[0] = make_cell(palette[0], attrib);
+      line[width - 1] = make_cell(palette[1], attrib);
+      for(unsigned short i = 0; i < title.size() && i < size.x; ++i)
+        line[i + 1] = make_cell(title[i], attrib);
+      blit(border_origin, line, width);
+
+      /* Bottom Row */
+      fill_cells(line, make_cell(palette[4], attrib), width);
+      line[0] = make_cell(palette[2], attrib);
+      line[width - 1] = make_cell(palette[3], attrib);
+      blit(border_origin + coord(0, size.y + 1), line, width);
+
+      /* Left and Right Columns */
+      cell_t side = make_cell(palette[5], attrib);
+      for(unsigned short i = 1; i <= size.y; ++i)
       {
-        palette[0] = 201;
-        palette[1] = 187;
-        palette[2] = 200;
-        palette[3] = 188;
-        palette[4] = 205;
-        palette[5] = 186;
+        blit(border_origin + coord(0, i), &side, 1);
+        blit(border_origin + coord(size.x + 1, i), &side, 1);
       }
-      else
+    }
+
+    /* Scroll the display */
+    void vga_screen::scroll()
+    {
+      scroll_framebuffer();
+      manager->present();
+    }
+
+    /* Copies the changed spans to VRAM */
+    void vga_screen::present()
+    {
+      if(border_dirty)
+        update_border();
+
+      if(view_offset)
       {
-        palette[0] = 218;
-        palette[1] = 191;
-        palette[2] = 192;
-        palette[3] = 217;
-        palette[4] = 196;
-        palette[5] = 179;
+        present_view();
+        return;
       }
 
-      /* Top Row */
+      /*
+       * VRAM only holds this screen's previous lines if nothing covers it,
+       * the recycled lines are already marked
+       */
+      if(scrolled)
       {
-        /* Upper left and right characters  */
-        put(palette[0], 0, 0);
-        put(palette[1], size.x + 1, 0);
-
-        /* Plot the title */
-        unsigned short index = 1;
-        for(; index <= title.size() && index <=size.x; ++index)
-          put(title[index-1], index, 0);
-
-        /* Plot remaining title bar */
-        for(; index <= size.x; ++index)
-          put(palette[4], index, 0);
+        if(!occluded && scrolled < size.y)
+        {
+          /* Moving the whole display takes the border along, so re-draw it */
+          if(manager->scroll_display(*this, scrolled))
+            update_border();
+          else
+            shift_vram(scrolled);
+        }
+        else
+          mark_all_dirty();
+
+        scrolled = 0;
       }
 
-      /* Bottom Row */
+      if(!any_dirty)
+        return;
+
+      for(unsigned short y = 0; y < size.y; ++y)
       {
-        /* Lower left and right characters */
-        put(palette[2], 0, size.y + 1);
-        put(palette[3], size.x + 1, size.y + 1);
+        dirty_span& span = dirty[ring_row(y)];
+        if(span.first > span.last)
+          continue;
 
-        /* Plot bar */
-        for(unsigned short i = 1; i <= size.x; ++i)
-          put(palette[4], i, size.y + 1);
+        blit(origin + coord{span.first, y}, row(y) + span.first, span.last - span.first + 1);
+
+        span = {clean_first, clean_last};
       }
 
-      /* Plot Left and Right Columns */
-      for(unsigned short i = 1; i <= size.y; ++i)
+      any_dirty = false;
+    }
+
+    /* Copies cells to VRAM, skipping the ones other screens own */
+    void vga_screen::blit(coord const& abs, cell_t const* cells, unsigned short count)
+    {
+      unsigned short end = abs.x + count;
+      cell_t* vram = manager->vram_row(abs.y);
+
+      for(vga_manager::owner_span const& span : manager->row_layout(abs.y))
       {
-        put(palette[5], 0, i);
-        put(palette[5], size.x+1, i);
+        if(span.owner != this || span.last <= abs.x || span.first >= end)
+          continue;
+
+        unsigned short first = span.first > abs.x ? span.first : abs.x;
+        unsigned short last = span.last < end ? span.last : end;
+        std::memcpy(vram + first, cells + (first - abs.x), (last - first) * sizeof(cell_t));
+        manager->damage(abs.y, first, last);
       }
     }
 
-    /* Scroll the display */
-    void vga_screen::scroll()
+    /* Moves the framebuffer up one line */
+    void vga_screen::scroll_framebuffer()
     {
-      /* Update framebuffer */
-      framebuffer.erase(framebuffer.begin());
-      framebuffer.emplace_back(size.x, vga_entry{' ', peek_attrib()});
-
-      if(is_active())
+      /* Save the top line */
+      if(history_lines)
       {
-        /* Memcpy line up */
-        for(unsigned short y = 1; y < size.y; ++y)
-          for(unsigned short x = 0; x < size.x; ++x)
-          {
-            char* src = vram_addr(coord(x,y) + origin);
-            char* dst = vram_addr(coord(x,y-1) + origin);
-            dst[0] = src[0];
-            dst[1] = src[1];
-          }
+        std::memcpy(history_rows[history_head], row(0), size.x * sizeof(cell_t));
 
-        /* Clear lowest line in the screen */
-        for(unsigned short x = 0; x < size.x; ++x)
-        {
-          char* dst = vram_addr(coord(x,size.y-1) + origin);
-          dst[0] = ' ';
-          dst[1] = peek_attrib();
-        }
+        if(++history_head == history_lines)
+          history_head = 0;
+        if(history_count < history_lines)
+          ++history_count;
+
+        /* Keep a moved-back view on the same lines */
+        if(view_offset && view_offset < history_count)
+          ++view_offset;
       }
+
+      /* Recycle the top line as the bottom line */
+      fill_cells(row(0), make_cell(' ', peek_attrib()), size.x);
+      dirty[head] = {0, static_cast<unsigned short>(size.x - 1)};
+      any_dirty = true;
+
+      if(++head == size.y)
+        head = 0;
+
+      if(scrolled < size.y)
+        ++scrolled;
+    }
+
+    /* Resizes the history */
+    void vga_screen::set_scrollback(unsigned short lines)
+    {
+      history.clear();
+      history.resize(lines * size.x, make_cell(' ', peek_attrib()));
+      history_rows.clear();
+      for(unsigned short y = 0; y < lines; ++y)
+        history_rows.push_back(history.data() + y * size.x);
+
+      history_lines = lines;
+      history_head = 0;
+      history_count = 0;
+
+      scroll_view(-static_cast<int>(view_offset));
+    }
+
+    /* Moves the view */
+    void vga_screen::scroll_view(int lines)
+    {
+      int offset = view_offset + lines;
+      if(offset < 0)
+        offset = 0;
+      if(offset > history_count)
+        offset = history_count;
+
+      if(offset == view_offset)
+        return;
+
+      view_offset = offset;
+      view_dirty = true;
+
+      /* VRAM holds history, the live lines must all be re-drawn */
+      if(!view_offset)
+        mark_all_dirty();
+
+      manager->present();
+    }
+
+    /* Picks line y of the view */
+    cell_t const* vga_screen::view_row(unsigned short y)
+    {
+      if(y >= view_offset)
+        return row(y - view_offset);
+
+      /* The newest history row is just before history_head */
+      unsigned short back = view_offset - y;
+      unsigned short index = history_head >= back ? history_head - back
+                                                  : history_head + history_lines - back;
+      return history_rows[index];
+    }
+
+    /* Draws a moved-back view */
+    void vga_screen::present_view()
+    {
+      if(!any_dirty && !scrolled && !view_dirty)
+        return;
+
+      for(unsigned short y = 0; y < size.y; ++y)
+        blit(origin + coord{0, y}, view_row(y), size.x);
+
+      for(dirty_span& span : dirty)
+        span = {clean_first, clean_last};
+
+      any_dirty = false;
+      scrolled = 0;
+      view_dirty = false;
+    }
+
+    /* Finds the hardware cursor */
+    bool vga_screen::hw_cursor(coord& abs) const
+    {
+      if(!active || view_offset)
+        return false;
+
+      /* A pending wrap or scroll shows at the edge */
+      coord cursor = cursor_stack.back();
+      if(cursor.x >= size.x)
+        cursor.x = size.x - 1;
+      if(cursor.y >= size.y)
+        cursor.y = size.y - 1;
+
+      abs = origin + cursor;
+      return abs.x < manager->get_width() && abs.y < manager->get_height();
+    }
+
+    /* Moves VRAM up */
+    void vga_screen::shift_vram(unsigned short lines)
+    {
+      unsigned short width = manager->get_width();
+
+      /* Full-width screens are one contiguous region */
+      if(size.x == width)
+        std::memmove(manager->vram_row(origin.y), manager->vram_row(origin.y + lines),
+                     (size.y - lines) * width * sizeof(cell_t));
+      else
+        for(unsigned short y = origin.y; y + lines < origin.y + size.y; ++y)
+          std::memmove(manager->vram_row(y) + origin.x, manager->vram_row(y + lines) + origin.x,
+                       size.x * sizeof(cell_t));
+
+      for(unsigned short y = origin.y; y + lines < origin.y + size.y; ++y)
+        manager->damage(y, origin.x, origin.x + size.x);
+    }
+
+    /* Widens a row's changed span */
+    void vga_screen::mark_dirty(unsigned short x, unsigned short y)
+    {
+      dirty_span& span = dirty[ring_row(y)];
+      if(x < span.first)
+        span.first = x;
+      if(x > span.last)
+        span.last = x;
+
+      any_dirty = true;
+    }
+
+    /* Marks every cell */
+    void vga_screen::mark_all_dirty()
+    {
+      for(dirty_span& span : dirty)
+        span = {0, static_cast<unsigned short>(size.x - 1)};
+
+      /* Nothing left to shift */
+      scrolled = 0;
+      any_dirty = true;
     }
 
     /* Pops a cursor */
@@ -177,35 +400,48 @@ namespace io
     /* Re-draws everything with the current attribute */
     void vga_screen::flush_attrib()
     {
-      attrib_t attrib = peek_attrib();
+      cell_t attrib = make_cell(0, peek_attrib());
 
-      for(std::vector<vga_entry>& entries : framebuffer)
-        for(vga_entry& e : entries)
-          e.a = attrib;
+      for(cell_t& cell : framebuffer)
+        cell = (cell & 0x00ff) | attrib;
 
-      if(is_active())
-        for(unsigned short x = 0; x < size.x; ++x)
-          for(unsigned short y = 0; y < size.y; ++y)
-            vram_addr({x,y})[1] = attrib;
+      mark_all_dirty();
+      manager->present();
+    }
+
+    /* Blanks the screen */
+    void vga_screen::clear()
+    {
+      fill_cells(framebuffer.data(), make_cell(' ', peek_attrib()), framebuffer.size());
+
+      move_cursor({0,0});
+      view_offset = 0;
 
-      manager->passive_update_all();
+      mark_all_dirty();
+      manager->present();
     }
 
     /* Re-draws everything on the screen */
     void vga_screen::flush()
     {
-      update_border();
-
-      for(unsigned short x = 0; x < size.x; ++x)
-        for(unsigned short y = 0; y < size.y; ++y)
-        {
-          vram_addr(origin + coord{x,y})[0] = framebuffer[y][x].c;
-          vram_addr(origin + coord{x,y})[1] = framebuffer[y][x].a;
-        }
+      border_dirty = has_border;
+      mark_all_dirty();
+      present();
     }
 
     void vga_screen::event(keyboard::event_t const& e)
     {
+      /* Page through the scrollback */
+      if(e.type == keyboard::event_t::PRESSED &&
+         (e.key == keyboard::KEY_PAGE_UP || e.key == keyboard::KEY_PAGE_DOWN))
+        for(keyboard::key_t m : e.modifiers)
+          if(m == keyboard::KEY_LSHIFT || m == keyboard::KEY_RSHIFT)
+          {
+            int page = size.y / 2;
+            scroll_view(e.key == keyboard::KEY_PAGE_UP ? page : -page);
+            return;
+          }
+
       static int i = 0;
       write("Got event " + std::to_string(i++) + "\n");
     }
@@ -217,74 +453,321 @@ namespace io
         return;
 
       active = _active;
+      border_dirty = has_border;
       if(active)
         flush();
     }
 
-    /* VRAM from coordinate */
-    char* vga_screen::vram_addr(coord const& c)
+    /* Feeds the parser */
+    void vga_screen::put(char c)
     {
-      return reinterpret_cast<char*>(0xb8000) + 
-             (((c.y * manager->get_width()) + c.x) * 2);
+      switch(vt.consume(c))
+      {
+      case vt::action::PRINT:
+        print(c);
+        break;
+
+      case vt::action::EXECUTE:
+        execute(c);
+        break;
+
+      case vt::action::ESC_DISPATCH:
+        esc_dispatch();
+        break;
+
+      case vt::action::CSI_DISPATCH:
+        csi_dispatch();
+        break;
+
+      case vt::action::NONE:
+        break;
+      }
     }
 
     /* Writes a single character at the cursor */
-    void vga_screen::put(char c)
+    void vga_screen::print(char c)
+    {
+      coord& cursor = cursor_stack.back();
+
+      /* Bounds check and correct cursor */
+      if(cursor.x >= size.x)
+      {
+        cursor.x = 2;
+        ++cursor.y;
+      }
+
+      settle_cursor();
+
+      row(cursor.y)[cursor.x] = make_cell(c, peek_attrib());
+      mark_dirty(cursor.x, cursor.y);
+
+      ++cursor.x;
+    }
+
+    /* Control characters */
+    void vga_screen::execute(char c)
     {
       coord& cursor = cursor_stack.back();
 
-      /* Print character */
       switch(c)
       {
       case '\n':
         cursor.x = 0;
-        ++cursor.y;  
+        ++cursor.y;
+        break;
+
+      case '\r':
+        cursor.x = 0;
+        break;
+
+      case '\t':
+        cursor.x = std::min<unsigned short>((cursor.x & ~7) + 8, size.x);
         break;
 
-      default:
+      case '\b':
+        if(cursor.x)
+          --cursor.x;
+        break;
+      }
+    }
+
+    /* ESC sequences */
+    void vga_screen::esc_dispatch()
+    {
+      if(vt.get_intermediate())
+        return;
+
+      switch(vt.get_final())
+      {
+      case '7':
+        saved_cursor = peek_cursor();
+        break;
+
+      case '8':
+        move_cursor(saved_cursor);
+        break;
+
+      case 'c':
+        attrib_stack.back() = attrib_t(color::LIGHT_GRAY, color::BLACK);
+        bold = false;
+        clear();
+        break;
+      }
+    }
+
+    /* CSI sequences */
+    void vga_screen::csi_dispatch()
+    {
+      /* Private sequences (?25h and friends) aren't supported */
+      if(vt.get_intermediate())
+        return;
+
+      settle_cursor();
+      coord& cursor = cursor_stack.back();
+      unsigned short n = vt.param(0);
+      unsigned short max_x = size.x - 1;
+      unsigned short max_y = size.y - 1;
+
+      switch(vt.get_final())
+      {
+      case 'A':
+        cursor.y -= std::min(n, cursor.y);
+        break;
+
+      case 'B':
+        cursor.y += std::min<unsigned short>(n, max_y - cursor.y);
+        break;
+
+      case 'C':
+        cursor.x = std::min<unsigned short>(std::min(cursor.x, max_x) + n, max_x);
+        break;
+
+      case 'D':
+        cursor.x -= std::min(n, cursor.x);
+        break;
+
+      case 'E':
+        cursor.x = 0;
+        cursor.y += std::min<unsigned short>(n, max_y - cursor.y);
+        break;
+
+      case 'F':
+        cursor.x = 0;
+        cursor.y -= std::min(n, cursor.y);
+        break;
+
+      case 'G':
+        cursor.x = std::min<unsigned short>(n - 1, max_x);
+        break;
+
+      case 'H':
+      case 'f':
+        cursor.y = std::min<unsigned short>(vt.param(0) - 1, max_y);
+        cursor.x = std::min<unsigned short>(vt.param(1) - 1, max_x);
+        break;
+
+      case 'J':
+        switch(vt.param(0, 0))
         {
-          /* Bounds check and correct cursor */
-          if(cursor.x >= size.x)
-          {
-            cursor.x = 2;
-            ++cursor.y;
-          }
+        case 0:
+          erase(cursor.y, cursor.x, size.x);
+          for(unsigned short y = cursor.y + 1; y < size.y; ++y)
+            erase(y, 0, size.x);
+          break;
 
-          for(; cursor.y >= size.y; --cursor.y)
-            scroll();
+        case 1:
+          for(unsigned short y = 0; y < cursor.y; ++y)
+            erase(y, 0, size.x);
+          erase(cursor.y, 0, cursor.x + 1);
+          break;
 
-          framebuffer[cursor.y][cursor.x] = {c, peek_attrib()};
+        case 2:
+          for(unsigned short y = 0; y < size.y; ++y)
+            erase(y, 0, size.x);
+          break;
+        }
+        break;
 
-          if(is_active())
-          {
-            char* p = vram_addr(cursor + origin);
-            p[0] = c;
-            p[1] = peek_attrib();
-          }
+      case 'K':
+        switch(vt.param(0, 0))
+        {
+        case 0:
+          erase(cursor.y, cursor.x, size.x);
+          break;
 
-          ++cursor.x;
+        case 1:
+          erase(cursor.y, 0, cursor.x + 1);
+          break;
+
+        case 2:
+          erase(cursor.y, 0, size.x);
+          break;
         }
+        break;
+
+      case 'm':
+        select_graphic_rendition();
+        break;
+
+      case 's':
+        saved_cursor = cursor;
+        break;
+
+      case 'u':
+        cursor = saved_cursor;
+        break;
       }
     }
 
+    /* ANSI color order to BIOS color order */
+    static constexpr std::array<uint8_t, 8> ansi_colors = {0, 4, 2, 6, 1, 5, 3, 7};
+
+    /* Colors */
+    void vga_screen::select_graphic_rendition()
+    {
+      attrib_t& attrib = attrib_stack.back();
+      uint8_t fg = attrib.val & 0x0f;
+      uint8_t bg = (attrib.val >> 4) & 0x0f;
+
+      /* No parameters is a reset */
+      unsigned int count = vt.get_param_count() ? vt.get_param_count() : 1;
+      for(unsigned int i = 0; i < count; ++i)
+      {
+        uint16_t p = vt.param(i, 0);
+        if(p == 0)
+        {
+          fg = static_cast<uint8_t>(color::LIGHT_GRAY);
+          bg = static_cast<uint8_t>(color::BLACK);
+          bold = false;
+        }
+        else if(p == 1)
+        {
+          fg |= 0x08;
+          bold = true;
+        }
+        else if(p == 22)
+        {
+          fg &= 0x07;
+          bold = false;
+        }
+        else if(p >= 30 && p <= 37)
+          fg = ansi_colors[p - 30] | (bold ? 0x08 : 0);
+        else if(p == 39)
+          fg = static_cast<uint8_t>(color::LIGHT_GRAY) | (bold ? 0x08 : 0);
+        else if(p >= 40 && p <= 47)
+          bg = ansi_colors[p - 40];
+        else if(p == 49)
+          bg = static_cast<uint8_t>(color::BLACK);
+        else if(p >= 90 && p <= 97)
+          fg = ansi_colors[p - 90] | 0x08;
+        else if(p >= 100 && p <= 107)
+          bg = ansi_colors[p - 100] | 0x08;
+      }
+
+      attrib = attrib_t(static_cast<char>((bg << 4) | fg));
+    }
+
+    /* Blanks part of a line */
+    void vga_screen::erase(unsigned short y, unsigned short first, unsigned short last)
+    {
+      last = std::min(last, size.x);
+      if(first >= last)
+        return;
+
+      fill_cells(row(y) + first, make_cell(' ', peek_attrib()), last - first);
+      mark_dirty(first, y);
+      mark_dirty(last - 1, y);
+    }
+
+    /* Scrolls until the cursor is on the screen */
+    void vga_screen::settle_cursor()
+    {
+      for(coord& cursor = cursor_stack.back(); cursor.y >= size.y; --cursor.y)
+        scroll_framebuffer();
+    }
+
     /**
      * vga_manager definition
      */
     static std::vector<vga_manager*> managers;
 
-    /* Default constructor */
+    /* Text mode constructor */
     vga_manager::vga_manager(coord const& hw_size)
-    :size(hw_size)
+    :vga_manager(hw_size, nullptr)
+    { }
+
+    /* Cell display constructor */
+    vga_manager::vga_manager(cell_display const& _display)
+    :vga_manager(_display.size, &_display)
+    { }
+
+    /* Shared constructor */
+    vga_manager::vga_manager(coord const& hw_size, cell_display const* _display)
+    :passive_update(false)
+    ,size(hw_size)
+    ,display(_display)
+    ,vram(display ? display->cells : vram_base)
     ,active_border(color::WHITE, color::BLACK)
     ,inactive_border(color::DARK_GRAY, color::BLACK)
+    ,start(0)
+    ,cursor_offset(0xffff)
+    ,cursor_shown(true)
     {
+      /* Row pointers, and undo any scrolling left by the BIOS */
+      vram_rows.resize(size.y, vram);
+      damaged.resize(size.y, {0xffff, 0});
+      owners.resize(size.x * size.y, nullptr);
+      set_start(0);
+
       /* Clear screen */
-      for(unsigned short x = 0; x < size.x; ++x)
-        for(unsigned short y = 0; y < size.y; ++y)
-        {
-          char* p = reinterpret_cast<char*>(0xb8000) + (((y * size.x) + x) * 2);
-          p[0] = ' ';
-        }
+      fill_cells(vram, make_cell(' ', {color::LIGHT_GRAY, color::BLACK}), size.x * size.y);
+      for(unsigned short y = 0; y < size.y; ++y)
+        damage(y, 0, size.x);
+
+      /* Nothing is visible yet */
+      relayout();
+      flush_damage();
+      update_cursor();
 
       /* Register Self */
       managers.push_back(this);
@@ -322,16 +805,44 @@ namespace io
       }
 
       if(screen)
-      {
         screens.push_back(screen);
+
+      relayout();
+
+      if(screen)
         screen->set_active();
-      }
+
+      if(passive_update)
+        update_all();
+
+      flush_damage();
+      update_cursor();
+    }
+
+    /* Sends a screen to the bottom (erase and insert stay within the capacity, so this doesn't allocate) */
+    void vga_manager::lower(vga_screen& screen)
+    {
+      for(auto it = screens.begin(); it != screens.end(); ++it)
+        if(*it == &screen)
+        {
+          screens.erase(it);
+          break;
+        }
+
+      screens.insert(screens.begin(), &screen);
+      screen.set_inactive();
+
+      relayout();
+      update_all();
+      update_cursor();
     }
 
     /* Creates a new screen */
-    vga_screen& vga_manager::create_screen(coord const& origin, coord const& size, std::string const& title)
+    vga_screen& vga_manager::create_screen(coord const& origin, coord const& size, std::string_view title)
     {
       screens.insert(screens.begin(), new vga_screen(origin, size, title, this));
+      relayout();
+
       return *screens.front();
     }
 
@@ -342,6 +853,8 @@ namespace io
       for(vga_screen* screen : screens)
         if(screen->is_active())
           screen->update_border();
+
+      flush_damage();
     }
 
     /* Update inactive border color */
@@ -351,6 +864,8 @@ namespace io
       for(vga_screen* screen : screens)
         if(!screen->is_active())
           screen->update_border();
+
+      flush_damage();
     }
 
     /* Updates every screen */
@@ -358,6 +873,8 @@ namespace io
     {
       for(vga_screen* screen : screens)
         screen->flush();
+
+      flush_damage();
     }
 
     /* Calls update_all if passive_update is set */
@@ -367,6 +884,154 @@ namespace io
         update_all();
     }
 
+    /* Presents changed cells */
+    void vga_manager::present()
+    {
+      for(vga_screen* screen : screens)
+        if(passive_update || screen->is_active())
+          screen->present();
+
+      flush_damage();
+      update_cursor();
+    }
+
+    /* Scrolls with the CRTC */
+    bool vga_manager::scroll_display(vga_screen const& screen, unsigned short lines)
+    {
+      /* A cell display is in RAM, copying is as good as it gets */
+      if(display)
+        return false;
+
+      coord outer_origin = screen.outer_origin();
+      coord outer_size = screen.outer_size();
+      if(screen.occluded || outer_origin.x || outer_origin.y ||
+         outer_size.x != size.x || outer_size.y != size.y || lines >= size.y)
+        return false;
+
+      unsigned int next = start + lines * size.x;
+
+      /* Out of VRAM -- move the rows that stay visible back to the start */
+      if(next + size.x * size.y > crtc::vram_cells)
+      {
+        std::memmove(vram, vram + next, (size.y - lines) * size.x * sizeof(cell_t));
+        next = 0;
+      }
+
+      set_start(next);
+      return true;
+    }
+
+    /* Moves the display */
+    void vga_manager::set_start(uint16_t offset)
+    {
+      start = offset;
+      for(unsigned short y = 0; y < size.y; ++y)
+        vram_rows[y] = vram + start + y * size.x;
+
+      if(!display)
+        crtc::set_start(start);
+
+      /* The cursor is addressed from the start of VRAM */
+      cursor_offset = 0xffff;
+    }
+
+    /* Places the hardware cursor */
+    void vga_manager::update_cursor()
+    {
+      coord abs{0,0};
+      bool shown = !screens.empty() && screens.back()->hw_cursor(abs);
+      uint16_t offset = shown ? start + abs.y * size.x + abs.x : 0xffff;
+      if(shown == cursor_shown && offset == cursor_offset)
+        return;
+
+      if(display)
+        display->set_cursor(shown, abs);
+      else if(!shown)
+        crtc::hide_cursor();
+      else
+      {
+        if(offset != cursor_offset)
+          crtc::set_cursor(offset);
+        if(!cursor_shown)
+          crtc::show_cursor();
+      }
+
+      cursor_offset = offset;
+      cursor_shown = shown;
+    }
+
+    /* Hands damage to the display */
+    void vga_manager::flush_damage()
+    {
+      if(!display)
+        return;
+
+      for(unsigned short y = 0; y < size.y; ++y)
+      {
+        damage_span& span = damaged[y];
+        if(span.first >= span.last)
+          continue;
+
+        display->flush(y, span.first, span.last);
+        span = {0xffff, 0};
+      }
+    }
+
+    /* Recomputes which screen owns each cell */
+    void vga_manager::relayout()
+    {
+      /* Paint the screens bottom to top */
+      std::fill(owners.begin(), owners.end(), nullptr);
+      for(vga_screen* screen : screens)
+      {
+        coord first = screen->outer_origin();
+        coord last = first + screen->outer_size();
+
+        for(unsigned short y = first.y; y < last.y && y < size.y; ++y)
+          for(unsigned short x = first.x; x < last.x && x < size.x; ++x)
+            owners[y * size.x + x] = screen;
+      }
+
+      /* Each row becomes a list of runs */
+      layout.clear();
+      layout_rows.clear();
+      for(unsigned short y = 0; y < size.y; ++y)
+      {
+        layout_rows.push_back(layout.size());
+
+        vga_screen* const* cells = owners.data() + y * size.x;
+        for(unsigned short x = 0; x < size.x;)
+        {
+          unsigned short end = x + 1;
+          while(end < size.x && cells[end] == cells[x])
+            ++end;
+
+          /* Nobody draws uncovered cells, blank them once here */
+          if(cells[x])
+            layout.push_back({x, end, cells[x]});
+          else
+          {
+            fill_cells(vram_rows[y] + x, make_cell(' ', {color::LIGHT_GRAY, color::BLACK}), end - x);
+            damage(y, x, end);
+          }
+          x = end;
+        }
+      }
+      layout_rows.push_back(layout.size());
+
+      /* Only a screen owning its entire rectangle may move its own VRAM */
+      for(vga_screen* screen : screens)
+      {
+        unsigned int owned = 0;
+        for(owner_span const& span : layout)
+          if(span.owner == screen)
+            owned += span.last - span.first;
+
+        coord outer = screen->outer_size();
+        screen->occluded = owned != static_cast<unsigned int>(outer.x) * outer.y;
+      }
+    }
+
     /* Delegates the event to all managers */
     void vga_manager::global_event(keyboard::event_t const& e)
     {
@@ -380,6 +1045,15 @@ namespace io
       if(screens.empty())
         return;
 
+      /* Raise the bottom-most screen */
+      if(e.type == keyboard::event_t::PRESSED && e.key == keyboard::KEY_TAB)
+        for(keyboard::key_t m : e.modifiers)
+          if(m == keyboard::KEY_LALT || m == keyboard::KEY_RALT)
+          {
+            set_active(screens.front());
+            return;
+          }
+
       if(screens.back()->is_active())
         screens.back()->event(e);
     }
@@ -1,9 +1,14 @@
 #pragma once
 
 /* STL */
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+/* IO */
+#include "vt_parser"
+
 namespace io
 {
   namespace keyboard
@@ -28,6 +33,8 @@ namespace io
       :coord(o.x, o.y)
       { }
 
+      coord& operator=(coord const& o) = default;
+
       coord operator+(coord const& o) const
       { return coord(x + o.x, y + o.y); }
       void operator+=(coord const& o)
@@ -70,20 +77,39 @@ namespace io
     struct attrib_t
     {
       /* Constructs an attribute from two colors */
-      attrib_t(color fg, color bg)
+      constexpr attrib_t(color fg, color bg)
       :val((static_cast<char>(bg) << 4) | static_cast<char>(fg))
       { }
 
       /* Constructs an attribute from a raw value */
-      attrib_t(char a)
+      constexpr attrib_t(char a)
       :val(a)
       { }
 
       /* Implicit conversion to char */
-      operator char() const { return val; }
+      constexpr operator char() const { return val; }
       char val;
     };
 
+    /**
+     * @typedef cell_t
+     * @brief A character cell, packed the way VRAM stores it (character low, attribute high)
+     */
+    using cell_t = uint16_t;
+
+    /* Packs a character and attribute into a cell */
+    constexpr cell_t make_cell(char c, attrib_t a)
+    { return static_cast<uint8_t>(c) | (static_cast<uint8_t>(a.val) << 8); }
+
+    /**
+     * Fills cells with dword stores (two cells at a time)
+     *
+     * @param dst     The first cell
+     * @param value   The cell to fill with
+     * @param count   The number of cells
+     */
+    void fill_cells(cell_t* dst, cell_t value, std::size_t count);
+
     /**
      * @class vga_screen
      * 
@@ -96,14 +122,37 @@ namespace io
      * Cursor
      * - The cursor is a marker for the next write operation
      * - The topmost entry on the cursor stack defines the currently used cursor
+     * - The hardware cursor follows the active screen's cursor on the next present
      *
      * Only the active screen, and screens with passive, will update VRAM on write
      * All screens update the framebuffer on write
      * On becoming active, a screen draws it's entire framebuffer to the screen.
      *
+     * Dirty tracking
+     * - Writes only touch the framebuffer, and widen the changed span of their row
+     * - present() copies the changed spans to VRAM (as whole cells), then clears them
+     * - A write of any length therefore reaches VRAM in a single batch
+     *
+     * Framebuffer
+     * - One contiguous array of VRAM-formatted cells, used as a ring of rows
+     * - The row at head is the top line, so scrolling recycles it as the bottom line
+     * - Pending scrolls are presented by moving the VRAM rows, not re-drawing them
+     *
+     * Scrollback
+     * - Lines scrolled off the top are copied into a fixed-size ring of rows (see set_scrollback)
+     * - The view can be moved back into that history (Shift+PgUp/PgDn), it stays on the
+     *   same lines while output continues, and is re-drawn a whole row at a time
+     *
      * Attribute
      * - An attribute defines a color setting
      * - The topmost entry on the attribute stack defines the currently used attribute
+     *
+     * Escape sequences
+     * - Writes are run through a VT100 parser, so the same stream can go to a serial terminal
+     * - CR, LF (which also returns), TAB (8 columns), BS
+     * - CSI A/B/C/D/E/F/G/H/f move the cursor, CSI J/K erase the screen/line (0, 1, or 2)
+     * - CSI m (SGR) sets the topmost attribute: 0, 1, 22, 30-37, 39, 40-47, 49, 90-97, 100-107
+     * - CSI s/u and ESC 7/8 save and restore the cursor, ESC c resets the screen
      */
     class vga_manager;
     class vga_screen
@@ -115,19 +164,32 @@ namespace io
        * @param title     The title of the screen
        * @param manager   The manager of this screen
        */
-      vga_screen(coord const& origin, coord const& size, std::string const& title, vga_manager* manager);
+      vga_screen(coord const& origin, coord const& size, std::string_view title, vga_manager* manager);
+
+      /* Row pointers refer into the screen's own buffers */
+      vga_screen(vga_screen const&) = delete;
+      vga_screen& operator=(vga_screen const&) = delete;
+
+      /**
+       * Writes a range of characters at the cursor
+       */
+      vga_screen& write(std::string_view str);
+      vga_screen& operator<<(std::string_view str)
+        { return write(str); }
 
       /**
        * Writes a c-style string at the cursor
        */
-      vga_screen& write(char const* str);
+      vga_screen& write(char const* str)
+        { return write(std::string_view(str)); }
       vga_screen& operator<<(char const* str)
         { return write(str); }
 
       /**
        * Writes a c++ string at the cursor
        */
-      vga_screen& write(std::string const& str);
+      vga_screen& write(std::string const& str)
+        { return write(std::string_view(str)); }
       vga_screen& operator<<(std::string const& str)
         { return write(str); }
 
@@ -143,6 +205,19 @@ namespace io
        */
       void scroll();
 
+      /**
+       * Copies every cell changed since the last present to VRAM,
+       * and re-draws the border if it changed
+       *
+       * Only cells this screen owns in the manager's layout are drawn
+       */
+      void present();
+
+      /**
+       * Blanks the screen with the current attribute, and moves the cursor to {0,0}
+       */
+      void clear();
+
       /**
        * Restores the previous cursor
        *
@@ -176,15 +251,40 @@ namespace io
 
       /**
        * Process a keyboard event
+       *
+       * Shift+PgUp and Shift+PgDn move the view by half a screen
        */
       void event(keyboard::event_t const& e);
 
+      /**
+       * Sets the number of lines kept after scrolling off the top (discards the current history)
+       *
+       * @param lines   The history size, 0 for none (the default)
+       */
+      void set_scrollback(unsigned short lines);
+
+      /**
+       * Moves the view through the scrollback history, clamped to what is available
+       *
+       * @param lines   Positive to move back (up), negative to move towards the live screen
+       */
+      void scroll_view(int lines);
+
       /**
        * Trivial accessors 
        */
       bool is_active() const
         { return active; }
 
+      bool is_dirty() const
+        { return any_dirty || border_dirty || view_dirty; }
+
+      unsigned short get_view_offset() const
+        { return view_offset; }
+
+      unsigned short get_scrollback() const
+        { return history_lines; }
+
       std::string const& get_title() const
         { return title; }
 
@@ -210,21 +310,84 @@ namespace io
       void push_attrib(attrib_t attrib)
         { attrib_stack.push_back(attrib); }
 
-      void set_title(std::string const& _title)
+      void set_title(std::string_view _title)
         { title = _title; }
 
 
     protected:
-      /* Converts an absolute coordinate into the VRAM address */
-      char* vram_addr(coord const& c);
+      /* The manager lays out (and sets occluded on) its screens */
+      friend class vga_manager;
+
+      /* Copies count cells to VRAM starting at the absolute coordinate, skipping cells this screen doesn't own */
+      void blit(coord const& abs, cell_t const* cells, unsigned short count);
 
-      /* Writes a single character, using the cursor_stack */
+      /* Where the hardware cursor belongs, false if it should be hidden */
+      bool hw_cursor(coord& abs) const;
+
+      /* The rectangle covered by this screen, including the border */
+      coord outer_origin() const
+        { return has_border ? origin - coord{1,1} : origin; }
+      coord outer_size() const
+        { return has_border ? size + coord{2,2} : size; }
+
+      /* Runs a single character through the escape sequence parser */
       void put(char c);
 
+      /* Draws a single character at the cursor, using the cursor_stack */
+      void print(char c);
+
+      /* Acts on a control character */
+      void execute(char c);
+
+      /* Acts on a complete escape sequence */
+      void esc_dispatch();
+      void csi_dispatch();
+
+      /* Applies an SGR sequence to the topmost attribute */
+      void select_graphic_rendition();
+
+      /* Blanks the columns [first, last) of line y with the current attribute */
+      void erase(unsigned short y, unsigned short first, unsigned short last);
+
+      /* Scrolls away a cursor left below the last line */
+      void settle_cursor();
+
+      /* Moves the framebuffer up one line, without presenting it */
+      void scroll_framebuffer();
+
+      /* Moves the VRAM contents up the given number of lines */
+      void shift_vram(unsigned short lines);
+
+      /* The framebuffer row holding line y */
+      unsigned short ring_row(unsigned short y) const
+        { return (head + y < size.y) ? head + y : head + y - size.y; }
+
+      /* The framebuffer cells of line y */
+      cell_t* row(unsigned short y)
+        { return rows[ring_row(y)]; }
+
+      /* The cells currently shown on line y (from history if the view is moved back) */
+      cell_t const* view_row(unsigned short y);
+
+      /* Re-draws every line of a moved-back view */
+      void present_view();
+
+      /* Widens the changed span of row y to include column x */
+      void mark_dirty(unsigned short x, unsigned short y);
+
+      /* Marks every cell (but not the border) as changed */
+      void mark_all_dirty();
+
       /* True if this window has a border */
       bool has_border;
       /* Update booleans */
       bool active;
+      /* True if any row has a changed span */
+      bool any_dirty;
+      /* True if the border needs to be re-drawn */
+      bool border_dirty;
+      /* True if any cell of this screen is covered by another (or off the hardware screen) */
+      bool occluded;
       /* Screen geometry */
       coord origin, size;
       /* The manager this window belongs to */
@@ -236,10 +399,58 @@ namespace io
       /* The attribute stack */
       std::vector<attrib_t> attrib_stack;
 
-      /* The stored framebuffer */
-      struct vga_entry
-      { char c; attrib_t a; };
-      std::vector<std::vector<vga_entry>> framebuffer;
+      /* The escape sequence parser */
+      vt::parser vt;
+      /* The cursor saved by CSI s and ESC 7 */
+      coord saved_cursor;
+      /* True after SGR 1, so colors set after it are bright */
+      bool bold;
+
+      /* The stored framebuffer (size.y rows of size.x cells, see ring_row) */
+      std::vector<cell_t> framebuffer;
+      /* The start of each framebuffer row */
+      std::vector<cell_t*> rows;
+      /* A border edge is built here before it's blit (size.x + 2 cells) */
+      std::vector<cell_t> border_line;
+      /* The framebuffer row holding the top line */
+      unsigned short head;
+      /* The number of lines scrolled since the last present (at most size.y) */
+      unsigned short scrolled;
+
+      /* The scrollback history (history_lines rows of size.x cells) */
+      std::vector<cell_t> history;
+      /* The start of each history row */
+      std::vector<cell_t*> history_rows;
+      /* The history capacity, the history row to fill next, and the number of rows filled */
+      unsigned short history_lines, history_head, history_count;
+      /* How many lines the view is moved back, at most history_count */
+      unsigned short view_offset;
+      /* True if the view moved since the last present */
+      bool view_dirty;
+
+      /* The columns [first, last] of a framebuffer row changed since the last present (clean if first > last) */
+      struct dirty_span
+      { unsigned short first, last; };
+      std::vector<dirty_span> dirty;
+    };
+
+    /**
+     * @struct cell_display
+     * @brief A display other than VGA text mode, which shows a buffer of cells
+     *
+     * A vga_manager drawing to a display draws into its cells instead of VRAM,
+     * then passes every row's changed span to flush.
+     */
+    struct cell_display
+    {
+      /* The size of the display, in cells */
+      coord size;
+      /* The cells to draw into (size.y rows of size.x cells) */
+      cell_t* cells;
+      /* Shows the cells [first, last) of row y */
+      void (*flush)(unsigned short y, unsigned short first, unsigned short last);
+      /* Moves the cursor to a cell, or hides it */
+      void (*set_cursor)(bool shown, coord const& abs);
     };
 
     /**
@@ -261,6 +472,14 @@ namespace io
        */
       vga_manager(coord const& hw_size);
 
+      /**
+       * Constructs a manager drawing to a cell display instead of text VRAM
+       * (see vga_manager(coord const&))
+       *
+       * @param display   The display, which must outlive the manager
+       */
+      vga_manager(cell_display const& display);
+
       /* Destructor */
       ~vga_manager();
 
@@ -275,6 +494,17 @@ namespace io
       void set_active()
         { set_active(nullptr); }
 
+      /**
+       * @return The active screen, nullptr if there isn't one
+       */
+      vga_screen* get_active() const
+        { return (!screens.empty() && screens.back()->is_active()) ? screens.back() : nullptr; }
+
+      /**
+       * Moves a screen below every other screen (deactivating it), and re-draws what it uncovered
+       */
+      void lower(vga_screen& screen);
+
       /**
        * Requests a new screen with the given parameters
        * (see vga_screen::vga_screen)
@@ -284,7 +514,7 @@ namespace io
        * @param title
        * @return  A reference to the new screen
        */
-      vga_screen& create_screen(coord const& origin, coord const& size, std::string const& title);
+      vga_screen& create_screen(coord const& origin, coord const& size, std::string_view title);
 
       /**
        * Sets the active border, and updates all active windows
@@ -306,6 +536,39 @@ namespace io
        */
       void passive_update_all();
 
+      /**
+       * Copies the changed cells of the active screen to VRAM
+       * (and of every screen, if passive updates are enabled)
+       *
+       * Every screen draws only the cells it owns (see row_layout),
+       * so a visible cell is written exactly once, by its top-most screen
+       */
+      void present();
+
+      /**
+       * @struct owner_span
+       * @brief The columns [first, last) of a row, visible through a single screen
+       */
+      struct owner_span
+      {
+        unsigned short first, last;
+        vga_screen* owner;
+      };
+
+      /**
+       * The visible spans of a hardware row, left to right
+       * (cells no screen covers have no span)
+       *
+       * @param y   The hardware row
+       */
+      std::span<owner_span const> row_layout(unsigned short y) const
+      {
+        if(y >= size.y)
+          return {};
+
+        return {layout.data() + layout_rows[y], layout.data() + layout_rows[y + 1]};
+      }
+
       /**
        * Trivial accessors
        */
@@ -320,11 +583,50 @@ namespace io
       unsigned short get_height() const
         { return size.y; }
 
+      /* The VRAM cells of hardware row y (these move with the display start) */
+      cell_t* vram_row(unsigned short y) const
+        { return vram_rows[y]; }
+
+      /**
+       * Scrolls the entire display by moving the CRTC start address,
+       * instead of copying VRAM
+       *
+       * The content moves up by whole rows, only the rows scrolled
+       * into view need to be drawn (and anything that should not have
+       * moved, like a border). When the end of VRAM is reached, the rows
+       * that stay visible are copied back to the start.
+       *
+       * @param screen  The screen scrolling, which must be the only visible screen
+       * @param lines   The number of rows to scroll
+       * @return  False (without doing anything) if the screen doesn't cover the display
+       */
+      bool scroll_display(vga_screen const& screen, unsigned short lines);
+
+      /**
+       * Records that cells [first, last) of hardware row y were drawn
+       * (only a cell display needs to know)
+       */
+      void damage(unsigned short y, unsigned short first, unsigned short last)
+      {
+        if(!display)
+          return;
+
+        damage_span& span = damaged[y];
+        if(first < span.first)
+          span.first = first;
+        if(last > span.last)
+          span.last = last;
+      }
+
       /**
        * Trivial mutators
        */
       void enable_passive_update(bool enable = true)
-        { passive_update = enable; }
+      {
+        passive_update = enable;
+        if(enable)
+          update_all();
+      }
       void disable_passive_update()
         { passive_update = false; }
 
@@ -333,20 +635,61 @@ namespace io
 
     protected:
 
-      /* Instanced Event Handler */
+      /* Shared by the constructors, display is nullptr for text mode */
+      vga_manager(coord const& hw_size, cell_display const* display);
+
+      /* Passes the damaged spans to the cell display */
+      void flush_damage();
+
+      /* Instanced Event Handler -- Alt+Tab cycles the active screen */
       void event(keyboard::event_t const& event);
 
+      /* Recomputes the layout, after the stacking order or set of screens changes */
+      void relayout();
+
+      /* Moves the display start, and the VRAM row pointers with it */
+      void set_start(uint16_t offset);
+
+      /* Moves (or hides) the hardware cursor to match the active screen */
+      void update_cursor();
+
       /* The passive update flag */
       bool passive_update;
 
       /* The size of the entire screen */
       coord size;
 
+      /* The cell display, nullptr for text mode */
+      cell_display const* display;
+
+      /* The cells drawn to (text VRAM, or the display's cells) */
+      cell_t* vram;
+
+      /* The start of each hardware row in VRAM */
+      std::vector<cell_t*> vram_rows;
+
+      /* The columns [first, last) of each row drawn since the last flush_damage (clean if first >= last) */
+      struct damage_span
+      { unsigned short first, last; };
+      std::vector<damage_span> damaged;
+
       /* The active and inactive border attributes */
       attrib_t active_border, inactive_border;
 
-      /* The windows owned by this manager */
+      /* The windows owned by this manager (bottom-most first) */
       std::vector<vga_screen*> screens;
+
+      /* The topmost screen of every cell, rebuilt by relayout (size.y rows of size.x) */
+      std::vector<vga_screen*> owners;
+      /* Every row's visible spans, row y is [layout_rows[y], layout_rows[y+1]) */
+      std::vector<owner_span> layout;
+      std::vector<std::size_t> layout_rows;
+
+      /* The cell the display starts at */
+      uint16_t start;
+      /* The last cursor offset written to the CRTC, and whether it is shown */
+      uint16_t cursor_offset;
+      bool cursor_shown;
     };
   }
 }
@@ -0,0 +1,165 @@
+#include "vt_parser"
+
+namespace io
+{
+  namespace vt
+  {
+    /* Parameters are clamped (nothing uses more) */
+    static constexpr uint16_t param_limit = 9999;
+
+    /* The work done for a byte, besides changing state */
+    enum class step : uint8_t
+    {
+      IGNORE,
+      PRINT,
+      EXECUTE,
+      CLEAR,
+      PARAM,
+      COLLECT,
+      ESC_DISPATCH,
+      CSI_DISPATCH,
+    };
+
+    /* A single table entry */
+    struct transition
+    {
+      step work = step::IGNORE;
+      parser::state next = parser::GROUND;
+    };
+
+    using state_table = std::array<std::array<transition, 256>, parser::STATE_COUNT>;
+
+    /* Builds the transition table (a subset of the DEC ANSI parser) */
+    static constexpr state_table make_state_table()
+    {
+      state_table t{};
+
+      /* Sets every byte in [first, last] of a state */
+      auto range = [&t](parser::state s, unsigned int first, unsigned int last, step work, parser::state next)
+      {
+        for(unsigned int c = first; c <= last; ++c)
+          t[s][c] = {work, next};
+      };
+
+      for(unsigned int s = 0; s < parser::STATE_COUNT; ++s)
+      {
+        parser::state st = parser::state(s);
+
+        /* By default a state stays put, ignoring the byte */
+        range(st, 0x00, 0xff, step::IGNORE, st);
+
+        /* Controls execute from anywhere, CAN and SUB abort, ESC always starts over */
+        range(st, 0x00, 0x17, step::EXECUTE, st);
+        t[s][0x19] = {step::EXECUTE, st};
+        range(st, 0x1c, 0x1f, step::EXECUTE, st);
+        t[s][0x18] = {step::IGNORE, parser::GROUND};
+        t[s][0x1a] = {step::IGNORE, parser::GROUND};
+        t[s][0x1b] = {step::CLEAR, parser::ESCAPE};
+        t[s][0x7f] = {step::IGNORE, st};
+      }
+
+      /* Everything else in ground is printed (including code page 437 above 0x7f) */
+      range(parser::GROUND, 0x20, 0x7e, step::PRINT, parser::GROUND);
+      range(parser::GROUND, 0x80, 0xff, step::PRINT, parser::GROUND);
+
+      range(parser::ESCAPE, 0x20, 0x2f, step::COLLECT, parser::ESCAPE_INTERMEDIATE);
+      range(parser::ESCAPE, 0x30, 0x7e, step::ESC_DISPATCH, parser::GROUND);
+      t[parser::ESCAPE]['['] = {step::IGNORE, parser::CSI_ENTRY};
+
+      range(parser::ESCAPE_INTERMEDIATE, 0x30, 0x7e, step::ESC_DISPATCH, parser::GROUND);
+
+      range(parser::CSI_ENTRY, 0x30, 0x39, step::PARAM, parser::CSI_PARAM);
+      t[parser::CSI_ENTRY][';'] = {step::PARAM, parser::CSI_PARAM};
+      range(parser::CSI_ENTRY, 0x3c, 0x3f, step::COLLECT, parser::CSI_PARAM);
+      range(parser::CSI_ENTRY, 0x20, 0x2f, step::IGNORE, parser::CSI_IGNORE);
+      range(parser::CSI_ENTRY, 0x40, 0x7e, step::CSI_DISPATCH, parser::GROUND);
+
+      range(parser::CSI_PARAM, 0x30, 0x39, step::PARAM, parser::CSI_PARAM);
+      t[parser::CSI_PARAM][';'] = {step::PARAM, parser::CSI_PARAM};
+      t[parser::CSI_PARAM][':'] = {step::IGNORE, parser::CSI_IGNORE};
+      range(parser::CSI_PARAM, 0x3c, 0x3f, step::IGNORE, parser::CSI_IGNORE);
+      range(parser::CSI_PARAM, 0x20, 0x2f, step::IGNORE, parser::CSI_IGNORE);
+      range(parser::CSI_PARAM, 0x40, 0x7e, step::CSI_DISPATCH, parser::GROUND);
+
+      range(parser::CSI_IGNORE, 0x40, 0x7e, step::IGNORE, parser::GROUND);
+
+      return t;
+    }
+
+    /* Generated at compile time, lives in .rodata */
+    static constexpr state_table states = make_state_table();
+    static_assert(states[parser::CSI_PARAM]['m'].work == step::CSI_DISPATCH, "Bad state table");
+
+    /* Constructor */
+    parser::parser()
+    {
+      reset();
+    }
+
+    /* Back to ground */
+    void parser::reset()
+    {
+      current = GROUND;
+      params = {};
+      param_count = 0;
+      intermediate = 0;
+      final = 0;
+    }
+
+    /* Takes a single byte */
+    action parser::consume(char c)
+    {
+      uint8_t byte = static_cast<uint8_t>(c);
+      transition const& t = states[current][byte];
+      current = t.next;
+
+      switch(t.work)
+      {
+      case step::IGNORE:
+        return action::NONE;
+
+      case step::PRINT:
+        return action::PRINT;
+
+      case step::EXECUTE:
+        return action::EXECUTE;
+
+      case step::CLEAR:
+        params = {};
+        param_count = 0;
+        intermediate = 0;
+        return action::NONE;
+
+      case step::PARAM:
+        /* The first byte of a parameter list opens the first parameter */
+        if(!param_count)
+          param_count = 1;
+
+        if(byte == ';')
+          ++param_count;
+        else if(param_count <= max_params)
+        {
+          uint16_t& p = params[param_count - 1];
+          p = (p > (param_limit - 9) / 10) ? param_limit : p * 10 + (byte - '0');
+        }
+        return action::NONE;
+
+      case step::COLLECT:
+        intermediate = c;
+        return action::NONE;
+
+      case step::ESC_DISPATCH:
+        final = c;
+        return action::ESC_DISPATCH;
+
+      case step::CSI_DISPATCH:
+        final = c;
+        if(param_count > max_params)
+          param_count = max_params;
+        return action::CSI_DISPATCH;
+      }
+
+      return action::NONE;
+    }
+  }
+}
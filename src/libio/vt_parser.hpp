@@ -0,0 +1,110 @@
+#pragma once
+
+/* Compiler */
+#include <stdint.h>
+
+/* STL */
+#include <array>
+
+namespace io
+{
+  /**
+   * A streaming parser for the VT100/ANSI escape sequences
+   *
+   * The parser only splits the byte stream into printable characters, control characters
+   * and complete escape sequences, it's up to the terminal to act on them.
+   * Sequences are recognized with a transition table (indexed by state and byte),
+   * so a byte costs a single lookup.
+   *
+   * Supported
+   * - C0 controls (EXECUTE)
+   * - ESC <final> and ESC <intermediate> <final> (ESC_DISPATCH)
+   * - CSI [private] <params> <final> (CSI_DISPATCH), with up to max_params parameters
+   *
+   * Malformed sequences are consumed up to their final byte, then dropped.
+   */
+  namespace vt
+  {
+    /**
+     * @enum action
+     * @brief What the last byte completed
+     */
+    enum class action : uint8_t
+    {
+      NONE,
+      PRINT,
+      EXECUTE,
+      ESC_DISPATCH,
+      CSI_DISPATCH,
+    };
+
+    /**
+     * @class parser
+     * @brief The parser state for a single byte stream
+     */
+    class parser
+    {
+    public:
+      /* The number of parameters kept, any others are ignored */
+      static constexpr unsigned int max_params = 8;
+
+      parser();
+
+      /**
+       * Advances the parser by a single byte
+       *
+       * @param c   The next byte of the stream
+       * @return    What the byte completed (the byte itself for PRINT and EXECUTE)
+       */
+      action consume(char c);
+
+      /**
+       * Returns a parameter of the last CSI sequence
+       *
+       * @param i     The parameter index
+       * @param def   Returned for missing (and zero) parameters
+       */
+      uint16_t param(unsigned int i, uint16_t def = 1) const
+        { return (i < param_count && params[i]) ? params[i] : def; }
+
+      /**
+       * Trivial accessors (of the last dispatched sequence)
+       */
+      unsigned int get_param_count() const
+        { return param_count; }
+
+      char get_final() const
+        { return final; }
+
+      /* The private marker ('<', '=', '>' or '?'), or an intermediate byte, 0 if none */
+      char get_intermediate() const
+        { return intermediate; }
+
+      /**
+       * Drops any sequence in progress
+       */
+      void reset();
+
+      /**
+       * The parser states (see vt_parser.cpp)
+       */
+      enum state : uint8_t
+      {
+        GROUND,
+        ESCAPE,
+        ESCAPE_INTERMEDIATE,
+        CSI_ENTRY,
+        CSI_PARAM,
+        CSI_IGNORE,
+        STATE_COUNT,
+      };
+
+    private:
+      state current;
+      std::array<uint16_t, max_params> params;
+      unsigned int param_count;
+      char intermediate;
+      char final;
+    };
+  }
+}
@@ -87,4 +87,49 @@ namespace multiboot2
     uint32_t entry_count() const
     { return (size - sizeof(tag_memory_map)) / entry_size; }
   };
+
+  /**
+   * The specific tags for the ACPI RSDP (14 = ACPI 1.0, 15 = ACPI 2.0+)
+   * Both hold a copy of the RSDP structure
+   */
+  struct tag_acpi_rsdp : public tag_generic
+  {
+    const void* rsdp() const
+    { return this + 1; }
+  };
+
+  /**
+   * The specific tag for the framebuffer the bootloader set up (type 8)
+   */
+  struct tag_framebuffer : public tag_generic
+  {
+    enum framebuffer_type : uint8_t
+    {
+      INDEXED = 0,
+      RGB = 1,
+      EGA_TEXT = 2,
+    };
+
+    /* Valid for RGB framebuffers -- each component's bit position and width */
+    struct rgb_info
+    {
+      uint8_t red_position;
+      uint8_t red_size;
+      uint8_t green_position;
+      uint8_t green_size;
+      uint8_t blue_position;
+      uint8_t blue_size;
+    };
+
+    const rgb_info* rgb() const
+    { return reinterpret_cast<const rgb_info*>(this + 1); }
+
+    uint64_t addr;
+    uint32_t pitch;
+    uint32_t width;
+    uint32_t height;
+    uint8_t bpp;
+    framebuffer_type type;
+    uint16_t reserved;
+  };
 };
\ No newline at end of file
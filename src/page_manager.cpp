@@ -13,6 +13,12 @@ extern "C"
 /* The current page manager */
 static page_manager* current_manager = 0;
 
+/* Page attribute table -- entry 4 (PAT=1, PCD=0, PWT=0) is write-back by default, it becomes write-combining */
+#define MSR_PAT         0x277
+#define PAT_WC          0x01
+#define PAT_WC_ENTRY    4
+#define CPUID_PAT       (1 << 16)
+
 /**
  * Manages a single page directory
  */
@@ -37,6 +43,18 @@ public:
   bool set_write_access(bool);
   bool has_write_access() const;
 
+  /* Manages caching for the page */
+  bool set_cache_disabled(bool);
+  bool is_cache_disabled() const;
+
+  /* Selects PAT entry 4 (write-combining once the PAT is programmed) */
+  bool set_write_combining(bool);
+  bool is_write_combining() const;
+
+  /* True if the page is mapped */
+  bool is_present() const
+  { return present; }
+
 private:
   /* True if the page is present */
   unsigned present  : 1;
@@ -58,8 +76,10 @@ private:
   unsigned ignored : 1;
   /* Free for OS use */
   unsigned os_use : 3;
+  /* Selects the upper half of the PAT (with write_through and cache_disabled) */
+  unsigned pat : 1;
   /* Unused to ensure 4MiB physical paging */
-  unsigned padding : 10;
+  unsigned padding : 9;
   /* Pointer to 4MiB physical page address */
   unsigned table_ptr : 10;
 };
@@ -83,6 +103,7 @@ void page_manager::page_directory::reset()
   large_pages = true;
   ignored = 0;
   os_use = 0;
+  pat = 0;
   padding = 0;
   table_ptr = 0;
 }
@@ -123,6 +144,55 @@ bool page_manager::page_directory::has_write_access() const
   return write_access;
 }
 
+/* Manage caching */
+bool page_manager::page_directory::set_cache_disabled(bool _cache_disabled)
+{
+  return (cache_disabled = _cache_disabled);
+}
+
+bool page_manager::page_directory::is_cache_disabled() const
+{
+  return cache_disabled;
+}
+
+bool page_manager::page_directory::set_write_combining(bool _write_combining)
+{
+  write_through = false;
+  cache_disabled = false;
+  return (pat = _write_combining);
+}
+
+bool page_manager::page_directory::is_write_combining() const
+{
+  return pat && !write_through && !cache_disabled;
+}
+
+/* Programs PAT_WC_ENTRY as write-combining, false if there is no PAT */
+static bool enable_pat()
+{
+  static bool enabled = false;
+  if(enabled)
+    return true;
+
+  uint32_t a = 1, b, c = 0, d;
+  asm volatile("cpuid" : "+a"(a), "=b"(b), "+c"(c), "=d"(d));
+  if(!(d & CPUID_PAT))
+    return false;
+
+  uint32_t lo, hi;
+  asm volatile("rdmsr" : "=a"(lo), "=d"(hi) : "c"(MSR_PAT));
+
+  /* Entries 4-7 are in the high dword */
+  hi = (hi & ~0xffu) | PAT_WC;
+  static_assert(PAT_WC_ENTRY == 4, "The entry is set in the low byte of the high dword");
+
+  /* Nothing may be cached with the old attributes */
+  asm volatile("wbinvd" : : : "memory");
+  asm volatile("wrmsr" : : "c"(MSR_PAT), "a"(lo), "d"(hi));
+
+  return (enabled = true);
+}
+
 /* Initialization */
 void page_manager::init(page_directory* _directory)
 {
@@ -189,6 +259,68 @@ void page_manager::alloc_page(void* v, void* p)
   update_paging();
 }
 
+/* Identity-maps a page outside of the physical pool */
+void* page_manager::map_identity(uintptr_t phys, bool uncached)
+{
+  void* page = reinterpret_cast<void*>(phys & ~static_cast<uintptr_t>(0x3fffff));
+  page_directory& dir = directory[phys >> 22];
+
+  if(dir.is_present())
+  {
+    /* Already mapped, it just has to be mapped here */
+    if(dir.get_phys_address() != page)
+      apex::__break();
+  }
+  else
+  {
+    /* The frame is in use, so the pool must never hand it out elsewhere */
+    alloc_virt_page(page);
+    alloc_phys_page(page);
+    dir.set_phys_address(page);
+    dir.set_write_access(true);
+    dir.set_cache_disabled(uncached);
+    update_paging();
+  }
+
+  return reinterpret_cast<void*>(phys);
+}
+
+/* Identity-maps a framebuffer */
+void* page_manager::map_write_combining(uintptr_t phys, uint32_t length)
+{
+  bool wc = enable_pat();
+
+  uintptr_t first = phys & ~static_cast<uintptr_t>(0x3fffff);
+  for(uintptr_t page = first; page - first < (phys - first) + length; page += 0x400000)
+  {
+    page_directory& dir = directory[page >> 22];
+    if(dir.is_present())
+    {
+      if(dir.get_phys_address() != reinterpret_cast<void*>(page))
+        apex::__break();
+    }
+    else
+    {
+      alloc_virt_page(page);
+      alloc_phys_page(page);
+      dir.set_phys_address(reinterpret_cast<void*>(page));
+      dir.set_write_access(true);
+    }
+
+    if(wc)
+      dir.set_write_combining(true);
+    else
+      dir.set_cache_disabled(true);
+
+    /* The last page of the address space */
+    if(page == 0xffc00000)
+      break;
+  }
+
+  update_paging();
+  return reinterpret_cast<void*>(phys);
+}
+
 /* Allocates the next available page */
 void* page_manager::alloc_page()
 {
@@ -69,6 +69,28 @@ public:
    */
   void alloc_page(void* virt, void* phys);
 
+  /**
+   * Identity-maps the page containing phys, if it isn't mapped already
+   * For firmware tables and device registers, which aren't in the
+   *   physical allocation pool.
+   * Breaks if the page is already mapped somewhere else.
+   * @param phys      The physical address to map
+   * @param uncached  True to disable caching (i.e. for MMIO registers)
+   * @return The virtual address of phys
+   */
+  void* map_identity(uintptr_t phys, bool uncached = false);
+
+  /**
+   * Identity-maps the pages covering [phys, phys+length) as write-combining
+   * For framebuffers, which are written in bulk and never read back.
+   * Falls back to uncached if the CPU has no PAT.
+   * Breaks if a page is already mapped somewhere else.
+   * @param phys      The physical address to map
+   * @param length    The number of bytes to map
+   * @return The virtual address of phys
+   */
+  void* map_write_combining(uintptr_t phys, uint32_t length);
+
   /**
    * Allocates a single page and returns it
    * @return A pointer to the start of the allocated virtual page
@@ -106,7 +128,7 @@ public:
    */
   void free_virt_page(void* page);
   void free_virt_page(uintptr_t page)
-  { free_phys_page(reinterpret_cast<void*>(page)); }
+  { free_virt_page(reinterpret_cast<void*>(page)); }
 
   /**
    * Marks a portion of virtual RAM as allocated,
@@ -115,7 +137,7 @@ public:
    */
   void alloc_virt_page(void* page);
   void alloc_virt_page(uintptr_t page)
-  { alloc_phys_page(reinterpret_cast<void*>(page)); }
+  { alloc_virt_page(reinterpret_cast<void*>(page)); }
 
   /** Access Methods */
   bool is_enabled() const { return enabled; }
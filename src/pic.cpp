@@ -8,6 +8,38 @@
 #define PIC2_CMD   0xa0
 #define PIC2_DATA  0xa1
 
+/* The cascade IRQ on the master */
+#define PIC_CASCADE 0x04
+
+/* The masks we want (1 = masked) */
+static uint16_t imr = 0xffff;
+
+/* The masks the hardware has */
+static uint16_t hw_imr = 0xffff;
+
+/* The begin_update() nesting depth */
+static unsigned int batch_depth;
+
+/* Writes only the controllers whose mask differs from the hardware */
+static void sync_masks()
+{
+  if(batch_depth)
+    return;
+
+  /* The slave needs the cascade open */
+  uint16_t next = imr;
+  if((next >> 8) != 0xff)
+    next &= ~PIC_CASCADE;
+
+  uint16_t changed = next ^ hw_imr;
+  if(changed & 0xff)
+    ports::out_8(PIC1_DATA, next & 0xff);
+  if(changed >> 8)
+    ports::out_8(PIC2_DATA, next >> 8);
+
+  hw_imr = next;
+}
+
 /** Enables the PIC, but with all IRQs masked */
 void pic::initialize()
 {
@@ -37,22 +69,42 @@ void pic::initialize()
   ports::out_8(PIC2_DATA, 0x01);
   ports::io_wait();
 
-  /* Set interrupt masks */
-  mask(irq_t::ALL);
+  /* Set interrupt masks (both controllers, whatever the cache says) */
+  imr = hw_imr = 0xffff;
+  ports::out_8(PIC1_DATA, 0xff);
+  ports::out_8(PIC2_DATA, 0xff);
 }
 
 /* Unmask IRQ */
 void pic::unmask(irq_t irqs)
 {
-  ports::out_8(PIC1_DATA, ports::in_8(PIC1_DATA) & ~static_cast<uint8_t>(irqs & 0xff));
-  ports::out_8(PIC2_DATA, ports::in_8(PIC2_DATA) & ~static_cast<uint8_t>((irqs >> 8) & 0xff));
+  imr &= ~static_cast<uint16_t>(irqs);
+  sync_masks();
 }
 
 /* Mask IRQ */
 void pic::mask(irq_t irqs)
 {
-  ports::out_8(PIC1_DATA, ports::in_8(PIC1_DATA) | static_cast<uint8_t>(irqs & 0xff));
-  ports::out_8(PIC2_DATA, ports::in_8(PIC2_DATA) | static_cast<uint8_t>((irqs >> 8) & 0xff));
+  imr |= static_cast<uint16_t>(irqs);
+  sync_masks();
+}
+
+/* Cached mask */
+pic::irq_t pic::get_mask()
+{
+  return imr;
+}
+
+/* Batching */
+void pic::begin_update()
+{
+  ++batch_depth;
+}
+
+void pic::end_update()
+{
+  --batch_depth;
+  sync_masks();
 }
 
 /* Acknowledge IRQ */
@@ -19,6 +19,7 @@ namespace pic
     /* Readable enumeration */
     enum E
     {
+      TIMER = 0x1,
       KEYBOARD = 0x2,
 
       ALL = 0xffff,
@@ -55,6 +56,10 @@ namespace pic
   void initialize();
 
   /**
+   * Masks are cached, so these only write the controller(s) whose
+   *   mask actually changed (and never read the hardware)
+   * IRQ2 (the cascade) is unmasked automatically while any slave IRQ is
+   *
    * @param irq   The IRQs to enable
    */
   void unmask(irq_t irqs);
@@ -64,6 +69,31 @@ namespace pic
    */
   void mask(irq_t irqs);
 
+  /**
+   * @return The cached mask (16-bit field of which IRQs are disabled)
+   */
+  irq_t get_mask();
+
+  /**
+   * Defers mask writes until the matching end_update()
+   * Updates can nest, the hardware is written once at the outermost end
+   */
+  void begin_update();
+  void end_update();
+
+  /**
+   * @struct update_batch
+   * @brief Batches every mask/unmask made in its scope
+   */
+  struct update_batch
+  {
+    update_batch() { begin_update(); }
+    ~update_batch() { end_update(); }
+
+    update_batch(update_batch const&) = delete;
+    update_batch& operator=(update_batch const&) = delete;
+  };
+
   /**
    * @param irq   The IRQ to acknowledge (sends EOI to master + slave (if needed))
    */
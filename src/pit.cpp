@@ -0,0 +1,89 @@
+#include "pit"
+
+/* Kernel */
+#include "interrupts"
+#include "irq"
+#include "ports"
+
+/* APEX */
+#include <clock>
+
+#define PIT_CH0       0x40
+#define PIT_CH2       0x42
+#define PIT_CMD       0x43
+#define PIT_CH2_GATE  0x61
+
+/* Command bits */
+#define PIT_SEL_CH0   0x00
+#define PIT_SEL_CH2   0x80
+#define PIT_LOHI      0x30
+#define PIT_MODE0     0x00  /* Interrupt on terminal count */
+
+/* Port 0x61 bits */
+#define GATE_CH2      0x01
+#define GATE_SPEAKER  0x02
+#define GATE_OUT2     0x20
+
+/* The length of the calibration window */
+#define CALIBRATE_MS  10
+
+/* The longest one-shot the 16-bit counter can time, in ns */
+#define MAX_ONESHOT_NS  (0xffffull * 1000000000 / pit::base_frequency)
+
+/* IRQ0 -- the wakeup is the point, the idle loop runs the expired timers */
+static void int_handler(interrupts::interrupt_frame&)
+{ }
+
+/* Stops the firmware's periodic tick, channel 0 stays quiet until armed */
+void pit::initialize()
+{
+  /* In mode 0, the counter holds until it's given a count */
+  ports::out_8(PIT_CMD, PIT_SEL_CH0 | PIT_LOHI | PIT_MODE0);
+
+  irq::install(0, &int_handler);
+}
+
+/* One-shot */
+void pit::set_deadline(uint64_t deadline)
+{
+  uint64_t now = apex::clock::now();
+  uint64_t delay = deadline > now ? deadline - now : 0;
+  if(delay > MAX_ONESHOT_NS)
+    delay = MAX_ONESHOT_NS;
+
+  /* A count of 0 would mean 0x10000, so fire as soon as possible instead */
+  uint32_t count = static_cast<uint32_t>(delay * base_frequency / 1000000000);
+  if(count < 1)
+    count = 1;
+
+  /* Writing the command stops the count, the high byte restarts it */
+  ports::out_8(PIT_CMD, PIT_SEL_CH0 | PIT_LOHI | PIT_MODE0);
+  ports::out_8(PIT_CH0, count & 0xff);
+  ports::out_8(PIT_CH0, (count >> 8) & 0xff);
+}
+
+/* TSC calibration */
+uint32_t pit::calibrate_tsc()
+{
+  constexpr uint32_t count = base_frequency * CALIBRATE_MS / 1000;
+
+  /* Gate low, speaker off -- channel 2 holds until the gate rises */
+  uint8_t gate = ports::in_8(PIT_CH2_GATE) & ~(GATE_CH2 | GATE_SPEAKER);
+  ports::out_8(PIT_CH2_GATE, gate);
+
+  ports::out_8(PIT_CMD, PIT_SEL_CH2 | PIT_LOHI | PIT_MODE0);
+  ports::out_8(PIT_CH2, count & 0xff);
+  ports::out_8(PIT_CH2, (count >> 8) & 0xff);
+
+  /* Raise the gate to start counting, OUT2 goes high at terminal count */
+  ports::out_8(PIT_CH2_GATE, gate | GATE_CH2);
+  uint64_t start = apex::clock::rdtsc();
+
+  while(!(ports::in_8(PIT_CH2_GATE) & GATE_OUT2))
+    ;
+
+  uint64_t end = apex::clock::rdtsc();
+  ports::out_8(PIT_CH2_GATE, gate);
+
+  return static_cast<uint32_t>((end - start) / CALIBRATE_MS);
+}
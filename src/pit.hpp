@@ -0,0 +1,37 @@
+#pragma once
+
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * Driver for the 8253/8254 Programmable Interval Timer
+ */
+namespace pit
+{
+  /* The PIT's input clock, in Hz */
+  constexpr uint32_t base_frequency = 1193182;
+
+  /**
+   * Installs the IRQ0 handler -- there is no periodic tick,
+   *   channel 0 only interrupts when armed by set_deadline()
+   * Requires irq::initialize()
+   */
+  void initialize();
+
+  /**
+   * Arms channel 0 as a one-shot IRQ0
+   * Deadlines past ~55ms fire early (the counter is 16 bits), so re-arm on wakeup
+   * Requires apex::clock to be calibrated
+   *
+   * @param deadline  The apex::clock::now() to fire at (in the past fires right away)
+   */
+  void set_deadline(uint64_t deadline);
+
+  /**
+   * Measures the TSC against a 10ms one-shot on channel 2
+   * Busy-waits, and doesn't need interrupts
+   *
+   * @return TSC ticks per millisecond
+   */
+  uint32_t calibrate_tsc();
+}
@@ -1,26 +1,105 @@
 #pragma once
 
+/* Compiler */
+#include <stdint.h>
+
+/* STL */
+#include <cstddef>
+
 /**
  * Defines some functions to interface with IO ports
+ *
+ * Everything is inline asm, so constant ports below 0x100 compile to the
+ *   immediate form of in/out, and nothing pays for a call.
  */
 namespace ports
 {
+  /* Unused port (POST codes), written to delay for an IO cycle */
+  constexpr uint16_t delay_port = 0x80;
+
   /**
-   * The functions provided via asm
+   * Writes 8/16/32 bit values to the given port
    */
-  extern "C"
+  inline void out_8(uint16_t port, uint8_t byte)
+  { asm volatile("outb %0, %1" : : "a"(byte), "Nd"(port)); }
+
+  inline void out_16(uint16_t port, uint16_t word)
+  { asm volatile("outw %0, %1" : : "a"(word), "Nd"(port)); }
+
+  inline void out_32(uint16_t port, uint32_t dword)
+  { asm volatile("outl %0, %1" : : "a"(dword), "Nd"(port)); }
+
+  /**
+   * Reads 8/16/32 bit values from the given port
+   */
+  inline uint8_t in_8(uint16_t port)
   {
-    /* Writes 8/16/32 bit values to the given port */
-    void out_8(uint16_t port, uint8_t byte);
-    void out_16(uint16_t port, uint16_t byte);
-    void out_32(uint16_t port, uint32_t byte);
-
-    /* Reads 8/16/32 bit values from the given port */
-    uint8_t in_8(uint16_t port);
-    uint16_t in_16(uint16_t port);
-    uint32_t in_32(uint16_t port);
-
-    /* Performs an IO cycle */
-    void io_wait();
+    uint8_t byte;
+    asm volatile("inb %1, %0" : "=a"(byte) : "Nd"(port));
+    return byte;
   }
+
+  inline uint16_t in_16(uint16_t port)
+  {
+    uint16_t word;
+    asm volatile("inw %1, %0" : "=a"(word) : "Nd"(port));
+    return word;
+  }
+
+  inline uint32_t in_32(uint16_t port)
+  {
+    uint32_t dword;
+    asm volatile("inl %1, %0" : "=a"(dword) : "Nd"(port));
+    return dword;
+  }
+
+  /**
+   * Port numbers known at compile time, checked to fit the immediate form
+   */
+  template<uint16_t port>
+  inline void out_8(uint8_t byte)
+  {
+    static_assert(port < 0x100, "Immediate ports must be 8-bit");
+    asm volatile("outb %0, %1" : : "a"(byte), "N"(port));
+  }
+
+  template<uint16_t port>
+  inline uint8_t in_8()
+  {
+    static_assert(port < 0x100, "Immediate ports must be 8-bit");
+    uint8_t byte;
+    asm volatile("inb %1, %0" : "=a"(byte) : "N"(port));
+    return byte;
+  }
+
+  /**
+   * String IO -- transfers count values between a port and memory (rep ins/outs)
+   *
+   * @param port    The port to transfer with
+   * @param buffer  The memory to transfer to/from
+   * @param count   The number of values (not bytes) to transfer
+   */
+  inline void ins_8(uint16_t port, uint8_t* buffer, std::size_t count)
+  { asm volatile("rep insb" : "+D"(buffer), "+c"(count) : "d"(port) : "memory"); }
+
+  inline void ins_16(uint16_t port, uint16_t* buffer, std::size_t count)
+  { asm volatile("rep insw" : "+D"(buffer), "+c"(count) : "d"(port) : "memory"); }
+
+  inline void ins_32(uint16_t port, uint32_t* buffer, std::size_t count)
+  { asm volatile("rep insl" : "+D"(buffer), "+c"(count) : "d"(port) : "memory"); }
+
+  inline void outs_8(uint16_t port, uint8_t const* buffer, std::size_t count)
+  { asm volatile("rep outsb" : "+S"(buffer), "+c"(count) : "d"(port) : "memory"); }
+
+  inline void outs_16(uint16_t port, uint16_t const* buffer, std::size_t count)
+  { asm volatile("rep outsw" : "+S"(buffer), "+c"(count) : "d"(port) : "memory"); }
+
+  inline void outs_32(uint16_t port, uint32_t const* buffer, std::size_t count)
+  { asm volatile("rep outsl" : "+S"(buffer), "+c"(count) : "d"(port) : "memory"); }
+
+  /**
+   * Performs an IO cycle (a short delay for slow devices like the PIC)
+   */
+  inline void io_wait()
+  { out_8<delay_port>(0); }
 }
@@ -0,0 +1,216 @@
+/* Kernel */
+#include "irq"
+#include "ports"
+
+/* IO */
+#include <serial>
+
+/* APEX */
+#include <spsc_ring>
+
+#define COM1        0x3f8
+#define COM1_DATA   (COM1 + 0)  /* DLL when DLAB is set */
+#define COM1_IER    (COM1 + 1)  /* DLM when DLAB is set */
+#define COM1_IIR    (COM1 + 2)  /* FCR when written */
+#define COM1_FCR    (COM1 + 2)
+#define COM1_LCR    (COM1 + 3)
+#define COM1_MCR    (COM1 + 4)
+#define COM1_LSR    (COM1 + 5)
+
+#define COM1_IRQ    4
+
+/* Line status -- transmit holding register (and FIFO) empty */
+#define LSR_THRE    0x20
+
+/* Interrupt enable -- transmit holding register empty */
+#define IER_THRE    0x02
+
+/* Interrupt identification -- no interrupt pending, and the THRE interrupt */
+#define IIR_NONE    0x01
+#define IIR_ID      0x0e
+#define IIR_THRE    0x02
+
+/* Modem control -- DTR, RTS, and OUT2 (which gates the IRQ line) */
+#define MCR_DTR_RTS 0x03
+#define MCR_OUT2    0x08
+
+/* The transmit FIFO depth */
+#define TX_FIFO     16
+
+namespace io
+{
+  namespace serial
+  {
+    /* Filled by write(), drained by the ISR (or kick/flush, with interrupts disabled) */
+    static apex::spsc_ring<char, tx_size> tx;
+
+    /* True once the ISR is installed */
+    static bool interrupt_driven;
+
+    /* True while the UART is sending a batch from the ring (a THRE interrupt will follow) */
+    static volatile bool tx_busy;
+
+    /* Disables interrupts, returning the old eflags */
+    static uint32_t save_and_disable()
+    {
+      uint32_t eflags;
+      asm volatile("pushf; pop %0; cli" : "=r"(eflags) : : "memory");
+      return eflags;
+    }
+
+    /* Re-enables interrupts if they were enabled in eflags */
+    static void restore(uint32_t eflags)
+    {
+      if(eflags & 0x200)
+        asm volatile("sti" : : : "memory");
+    }
+
+    /* Moves up to a FIFO's worth from the ring to the UART (the FIFO must be empty) */
+    static bool fill_fifo()
+    {
+      char c;
+      unsigned int sent = 0;
+      for(; sent < TX_FIFO && tx.pop(c); ++sent)
+        ports::out_8(COM1_DATA, c);
+
+      return sent;
+    }
+
+    /* Starts sending if the UART is idle -- only call with interrupts disabled */
+    static void kick()
+    {
+      if(!tx_busy && (ports::in_8(COM1_LSR) & LSR_THRE))
+        tx_busy = fill_fifo();
+    }
+
+    /** Interrupt handling -- the FIFO is empty, refill it */
+    static void int_handler(interrupts::interrupt_frame&)
+    {
+      uint8_t iir;
+      while(!((iir = ports::in_8(COM1_IIR)) & IIR_NONE))
+        if((iir & IIR_ID) == IIR_THRE)
+          tx_busy = fill_fifo();
+    }
+
+    /** COM1 setup */
+    void initialize()
+    {
+      /* No interrupts -- output is polled until enable() */
+      ports::out_8(COM1_IER, 0x00);
+
+      /* 115200 / 1 = 115200 baud */
+      ports::out_8(COM1_LCR, 0x80);
+      ports::out_8(COM1_DATA, 0x01);
+      ports::out_8(COM1_IER, 0x00);
+
+      /* 8 bits, no parity, one stop bit (clears DLAB) */
+      ports::out_8(COM1_LCR, 0x03);
+
+      /* Enable and clear the FIFOs */
+      ports::out_8(COM1_FCR, 0xc7);
+
+      ports::out_8(COM1_MCR, MCR_DTR_RTS);
+    }
+
+    /** Interrupt-driven output */
+    void enable()
+    {
+      irq::install(COM1_IRQ, &int_handler);
+
+      uint32_t eflags = save_and_disable();
+      ports::out_8(COM1_MCR, MCR_DTR_RTS | MCR_OUT2);
+      ports::out_8(COM1_IER, IER_THRE);
+      interrupt_driven = true;
+      kick();
+      restore(eflags);
+    }
+
+    /** Polled output */
+    void disable()
+    {
+      uint32_t eflags = save_and_disable();
+      ports::out_8(COM1_IER, 0x00);
+      ports::out_8(COM1_MCR, MCR_DTR_RTS);
+      interrupt_driven = false;
+      restore(eflags);
+
+      irq::uninstall(COM1_IRQ, &int_handler);
+      flush();
+    }
+
+    /** Polled character output */
+    void put(char c)
+    {
+      while(!(ports::in_8(COM1_LSR) & LSR_THRE))
+        ;
+
+      ports::out_8(COM1_DATA, c);
+    }
+
+    /** Polled ring output */
+    void flush()
+    {
+      uint32_t eflags = save_and_disable();
+
+      /* Let any batch in flight finish, then send the rest a FIFO at a time */
+      do
+      {
+        while(!(ports::in_8(COM1_LSR) & LSR_THRE))
+          ;
+      } while(fill_fifo());
+
+      tx_busy = false;
+      restore(eflags);
+    }
+
+    /* Queues a character, waiting for the ISR to make room if the ring is full */
+    static void queue(char c)
+    {
+      while(!tx.push(c))
+      {
+        uint32_t eflags = save_and_disable();
+        kick();
+
+        /*
+         * Checked with interrupts off, so the THRE interrupt that frees a FIFO's worth
+         *   can't slip in before the hlt (sti's one instruction delay covers the gap)
+         */
+        if(tx.full() && tx_busy && (eflags & 0x200))
+          asm volatile("sti; hlt" ::: "memory");
+        else
+          restore(eflags);
+      }
+    }
+
+    /** String output */
+    void write(std::string_view str)
+    {
+      uint32_t eflags;
+      asm volatile("pushf; pop %0" : "=r"(eflags));
+
+      /* Nothing would drain the ring */
+      if(!interrupt_driven || !(eflags & 0x200))
+      {
+        flush();
+        for(char c : str)
+        {
+          if(c == '\n')
+            put('\r');
+          put(c);
+        }
+        return;
+      }
+
+      for(char c : str)
+      {
+        if(c == '\n')
+          queue('\r');
+        queue(c);
+      }
+
+      eflags = save_and_disable();
+      kick();
+      restore(eflags);
+    }
+  }
+}
@@ -0,0 +1,59 @@
+#include "softirq"
+
+/* Kernel */
+#include "idle"
+
+/* APEX */
+#include <clock>
+#include <spsc_ring>
+
+/* A single queued bottom half */
+struct work_item
+{
+  softirq::work_func func;
+  void* data;
+  uint64_t raised_tsc;
+};
+
+/* Filled by ISRs, drained by run() */
+static apex::spsc_ring<work_item, softirq::queue_size> queue;
+
+/* Accounting */
+static uint64_t max_delay_tsc;
+static volatile uint32_t dropped;
+
+/* Queue from an ISR */
+bool softirq::raise(work_func func, void* data)
+{
+  if(!queue.push({func, data, apex::clock::rdtsc()}))
+  {
+    dropped = dropped + 1;
+    return false;
+  }
+
+  idle::wake();
+  return true;
+}
+
+/* Drain */
+void softirq::run()
+{
+  work_item item;
+  while(queue.pop(item))
+  {
+    uint64_t delay = apex::clock::rdtsc() - item.raised_tsc;
+    if(delay > max_delay_tsc)
+      max_delay_tsc = delay;
+
+    item.func(item.data);
+  }
+}
+
+/* Accounting */
+softirq::stats_t softirq::stats()
+{
+  stats_t s;
+  s.max_delay_ns = apex::clock::to_ns(max_delay_tsc);
+  s.dropped = dropped;
+  return s;
+}
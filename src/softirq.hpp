@@ -0,0 +1,57 @@
+#pragma once
+
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * Deferred interrupt work (bottom halves)
+ *
+ * An interrupt handler (the top half) does only what can't wait --
+ *   reading the device and acknowledging the IRQ -- then raises
+ *   its bottom half, which runs later from the idle loop with
+ *   interrupts enabled.
+ *
+ * Interrupt gates don't nest, so ISRs are the queue's only producer,
+ *   and softirq::run() its only consumer.
+ */
+namespace softirq
+{
+  /** Signature for a bottom half */
+  using work_func = void(*)(void* data);
+
+  /* The most work items that can be waiting at once */
+  constexpr uint32_t queue_size = 64;
+
+  /**
+   * Queues a bottom half and wakes the idle loop
+   * Only call with interrupts disabled (i.e. from an ISR)
+   *
+   * @param func    The function to run
+   * @param data    Passed to func
+   * @return False if the queue was full (the work is dropped and counted)
+   */
+  bool raise(work_func func, void* data = nullptr);
+
+  /**
+   * Runs every queued bottom half
+   * (registered with the idle loop by the kernel)
+   */
+  void run();
+
+  /**
+   * @struct stats_t
+   * @brief Queue accounting
+   */
+  struct stats_t
+  {
+    /** @brief The longest time from raise() to the work running, in ns */
+    uint64_t max_delay_ns;
+    /** @brief Work items dropped because the queue was full */
+    uint32_t dropped;
+  };
+
+  /**
+   * @return The current queue accounting
+   */
+  stats_t stats();
+}
@@ -0,0 +1,67 @@
+#include "timers"
+
+/* APEX */
+#include <clock>
+
+/* The pending timers, earliest first */
+static apex::rbtree<timers::timer> pending;
+
+/* Arm */
+void timers::start(timer& t, uint64_t delay, uint64_t period)
+{
+  cancel(t);
+
+  t.deadline = apex::clock::now() + delay;
+  t.period = period;
+  t.pending = true;
+  pending.insert(t);
+}
+
+/* Disarm */
+void timers::cancel(timer& t)
+{
+  if(!t.pending)
+    return;
+
+  pending.erase(t);
+  t.pending = false;
+}
+
+/* Run expired timers */
+void timers::run()
+{
+  uint64_t now = apex::clock::now();
+
+  while(!pending.empty())
+  {
+    timer& t = *pending.begin();
+    if(t.deadline > now)
+      break;
+
+    pending.erase(t);
+    t.pending = false;
+
+    /* Re-arm from the old deadline so periodic timers don't drift */
+    if(t.period)
+    {
+      t.deadline += t.period;
+      if(t.deadline <= now)
+        t.deadline = now + t.period;
+
+      t.pending = true;
+      pending.insert(t);
+    }
+
+    /* May start or cancel any timer, including t */
+    t.func(t);
+  }
+}
+
+/* Next expiry */
+uint64_t timers::next_deadline()
+{
+  if(pending.empty())
+    return UINT64_MAX;
+
+  return pending.begin()->deadline;
+}
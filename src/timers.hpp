@@ -0,0 +1,76 @@
+#pragma once
+
+/* APEX */
+#include <rbtree>
+
+/* Compiler */
+#include <stdint.h>
+
+/**
+ * One-shot and periodic software timers on top of apex::clock
+ *
+ * Timers are kept in a tree ordered by deadline, and run from the main loop
+ *   (timers::run()), never from interrupt context -- so only use these
+ *   functions outside of ISRs.
+ *
+ * Timers are intrusive: the caller owns them, and must cancel a
+ *   pending timer before destroying it.
+ */
+namespace timers
+{
+  struct timer;
+
+  /** Signature for a timer callback */
+  using callback = void(*)(timer&);
+
+  /**
+   * @struct timer
+   * @brief A single (possibly periodic) timer
+   */
+  struct timer : apex::rbtree_hook<>
+  {
+    timer(callback _func)
+    :deadline(0)
+    ,period(0)
+    ,func(_func)
+    ,pending(false)
+    { }
+
+    /* Ordered by deadline */
+    bool operator<(timer const& other) const
+    { return deadline < other.deadline; }
+
+    /** @brief The apex::clock::now() at which this expires */
+    uint64_t deadline;
+    /** @brief The re-arm interval in ns, 0 for one-shot */
+    uint64_t period;
+    /** @brief The function to call on expiry */
+    callback func;
+    /** @brief True while the timer is waiting to expire */
+    bool pending;
+  };
+
+  /**
+   * Arms (or re-arms) a timer
+   *
+   * @param t         The timer to arm
+   * @param delay     Nanoseconds until it expires
+   * @param period    Nanoseconds between later expiries, 0 for one-shot
+   */
+  void start(timer& t, uint64_t delay, uint64_t period = 0);
+
+  /**
+   * Disarms a timer (does nothing if it isn't pending)
+   */
+  void cancel(timer& t);
+
+  /**
+   * Runs the callbacks of every expired timer, re-arming periodic ones
+   */
+  void run();
+
+  /**
+   * @return The deadline of the next timer, or UINT64_MAX if none are pending
+   */
+  uint64_t next_deadline();
+}